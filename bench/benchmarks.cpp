@@ -0,0 +1,474 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmarks.hpp"
+
+#include <QBuffer>
+#include <QEventLoop>
+#include <QFile>
+#include <QPolygonF>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "../src/canvas/canvas.hpp"
+#include "../src/common/renderitems.hpp"
+#include "../src/common/utils/segments.hpp"
+#include "../src/components/changestracker.hpp"
+#include "../src/context/applicationcontext.hpp"
+#include "../src/context/renderingcontext.hpp"
+#include "../src/context/spatialcontext.hpp"
+#include "../src/context/uicontext.hpp"
+#include "../src/data-structures/cachegrid.hpp"
+#include "../src/data-structures/orderedlist.hpp"
+#include "../src/data-structures/quadtree.hpp"
+#include "../src/item/freeform.hpp"
+#include "../src/serializer/itemrecord.hpp"
+#include "../src/serializer/journal.hpp"
+#include "../src/serializer/loadjob.hpp"
+#include "../src/serializer/serializer.hpp"
+#include "harness.hpp"
+#include "syntheticboard.hpp"
+
+namespace {
+using ItemPtr = std::shared_ptr<Item>;
+
+constexpr quint32 seed{0xD7A3};
+constexpr int pointsPerStroke{32};
+constexpr int viewportCount{64};
+constexpr int sampleCount{256};
+constexpr int reorderCount{1000};
+constexpr int quadtreeCapacity{100};
+const QSizeF viewportSize{1280, 800};
+
+QString caseName(const char *group, const char *name) {
+    return QString{"%1/%2"}.arg(group, name);
+}
+
+// the same `count` items in a random order
+QVector<ItemPtr> sample(const QVector<ItemPtr> &items, int count, quint32 sampleSeed) {
+    QVector<ItemPtr> out{items};
+    QRandomGenerator random{sampleSeed};
+    std::shuffle(out.begin(), out.end(), random);
+    out.resize(std::min<qsizetype>(count, out.size()));
+    return out;
+}
+
+std::unique_ptr<QuadTree> makeTree(
+    const QVector<ItemPtr> &items,
+    std::shared_ptr<OrderedList> orderedList = std::make_shared<OrderedList>()) {
+    auto tree{std::make_unique<QuadTree>(QRectF{QPointF{0, 0}, viewportSize},
+                                         quadtreeCapacity,
+                                         std::move(orderedList))};
+    tree->bulkLoad(items);
+    return tree;
+}
+
+// A stroke with shapes to test it against. The misses lie inside its
+// bounding box and overlap the boxes of segments without touching them, the
+// hits cross the middle segment.
+struct SegmentProbe {
+    QVector<QPointF> points{};
+    QRectF rectMiss{}, rectHit{};
+    QLineF lineMiss{}, lineHit{};
+    qsizetype rectHitSegments{}, lineHitSegments{};  // tested up to the first hit
+
+    // false if no shapes were found, e.g. for a stroke covering its whole box
+    bool make(quint32 probeSeed) {
+        using namespace Common::Utils::Segments;
+        constexpr int attempts{256};
+
+        if (points.size() < 2)
+            return false;
+
+        QRectF box{QPolygonF{points}.boundingRect()};
+
+        QRandomGenerator random{probeSeed};
+        auto randomPoint = [&]() {
+            return QPointF{box.left() + random.bounded(box.width()),
+                           box.top() + random.bounded(box.height())};
+        };
+
+        // of the shapes that miss, keep the one overlapping the bounding boxes
+        // of the most segments, those get past the first test of the kernels
+        qsizetype rectOverlaps{-1}, lineOverlaps{-1};
+        for (int i{0}; i < attempts; i++) {
+            QRectF rect{randomPoint(), QSizeF{2, 2} * (1 + random.bounded(8))};
+            qsizetype overlaps{boxOverlaps(rect)};
+            if (overlaps > rectOverlaps &&
+                !intersects(points.constData(), points.size(), rect, Kernel::Scalar)) {
+                rectMiss = rect;
+                rectOverlaps = overlaps;
+            }
+
+            QPointF center{randomPoint()};
+            QPointF half{QLineF::fromPolar(1 + random.bounded(16), random.bounded(360.0)).p2()};
+            QLineF line{center - half, center + half};
+            overlaps = boxOverlaps(QRectF{line.p1(), line.p2()}.normalized());
+            if (overlaps > lineOverlaps &&
+                !intersects(points.constData(), points.size(), line, Kernel::Scalar)) {
+                lineMiss = line;
+                lineOverlaps = overlaps;
+            }
+        }
+
+        if (rectOverlaps < 0 || lineOverlaps < 0)
+            return false;
+
+        qsizetype middle{points.size() / 2 - 1};
+        QLineF segment{points[middle], points[middle + 1]};
+        if (segment.length() == 0)
+            return false;
+
+        QPointF center{segment.center()};
+        QLineF normal{segment.normalVector().unitVector()};
+        QPointF offset{(normal.p2() - normal.p1()) * 5};
+        rectHit = QRectF{center - QPointF{1, 1}, QSizeF{2, 2}};
+        lineHit = QLineF{center - offset, center + offset};
+
+        rectHitSegments = firstHit(rectHit);
+        lineHitSegments = firstHit(lineHit);
+        return rectHitSegments > 0 && lineHitSegments > 0;
+    }
+
+    qsizetype boxOverlaps(const QRectF &box) const {
+        qsizetype overlaps{0};
+        for (qsizetype index{0}; index + 1 < points.size(); index++) {
+            QRectF segment{QRectF{points[index], points[index + 1]}.normalized()};
+            if (segment.left() <= box.right() && segment.right() >= box.left() &&
+                segment.top() <= box.bottom() && segment.bottom() >= box.top())
+                overlaps++;
+        }
+
+        return overlaps;
+    }
+
+    // how many segments are tested until one touches `shape`, 0 if none does
+    template <typename Shape>
+    qsizetype firstHit(const Shape &shape) const {
+        using namespace Common::Utils::Segments;
+
+        for (qsizetype index{0}; index + 1 < points.size(); index++) {
+            if (intersects(points.constData() + index, 2, shape, Kernel::Scalar))
+                return index + 1;
+        }
+
+        return 0;
+    }
+};
+
+// a mixed board, mostly strokes with some shapes and text, like a real one
+void loadBoard(ApplicationContext *context, int items) {
+    Bench::BoardSpec spec{};
+    spec.shapes = items * 15 / 100;
+    spec.texts = items * 5 / 100;
+    spec.strokes = items - spec.shapes - spec.texts;
+    spec.pointsPerStroke = pointsPerStroke;
+    spec.seed = seed;
+
+    context->reset();
+    context->spatialContext().quadtree().bulkLoad(Bench::makeBoard(spec));
+}
+}  // namespace
+
+namespace Bench {
+void benchQuadTree(Harness &harness, int count) {
+    QVector<ItemPtr> items{makeStrokes(count, pointsPerStroke, seed)};
+    QRectF initialRect{QPointF{0, 0}, viewportSize};
+
+    harness.run(caseName("quadtree", "insert"), count, count, [&]() {
+        QuadTree tree{initialRect, quadtreeCapacity, std::make_shared<OrderedList>()};
+        for (const ItemPtr &item : items) {
+            tree.insertItem(item);
+        }
+    });
+
+    harness.run(caseName("quadtree", "bulkload"), count, count, [&]() {
+        QuadTree tree{initialRect, quadtreeCapacity, std::make_shared<OrderedList>()};
+        tree.bulkLoad(items);
+    });
+
+    std::unique_ptr<QuadTree> tree{makeTree(items)};
+
+    QVector<QRectF> viewports{makeViewports(count, viewportCount, viewportSize, seed)};
+    harness.run(caseName("quadtree", "query"), count, viewports.size(), [&]() {
+        for (const QRectF &viewport : viewports) {
+            tree->queryItems(viewport);
+        }
+    });
+
+    // moves every sampled item back and forth, so the board stays the same
+    QVector<ItemPtr> moved{sample(items, sampleCount, seed)};
+    qreal direction{1};
+    harness.run(caseName("quadtree", "update"), count, moved.size(), [&]() {
+        for (const ItemPtr &item : moved) {
+            QRectF oldBoundingBox{item->boundingBox()};
+            item->translate(QPointF{50, 50} * direction);
+            tree->updateItem(item, oldBoundingBox);
+        }
+        direction = -direction;
+    });
+
+    harness.run(
+        caseName("quadtree", "delete"),
+        count,
+        count,
+        [&]() {
+            for (const ItemPtr &item : items) {
+                tree->deleteItem(item);
+            }
+        },
+        [&]() { tree = makeTree(items); });
+}
+
+void benchOrderedList(Harness &harness, int count) {
+    QVector<ItemPtr> items{makeStrokes(count, pointsPerStroke, seed)};
+    auto orderedList{std::make_shared<OrderedList>()};
+    std::unique_ptr<QuadTree> tree{makeTree(items, orderedList)};
+
+    QVector<ItemPtr> sampled{sample(items, sampleCount, seed)};
+    harness.run(caseName("orderedlist", "bringtofront"), count, sampled.size(), [&]() {
+        for (const ItemPtr &item : sampled) {
+            orderedList->bringToFront(item);
+        }
+    });
+
+    harness.run(caseName("orderedlist", "sendtoback"), count, sampled.size(), [&]() {
+        for (const ItemPtr &item : sampled) {
+            orderedList->sendToBack(item);
+        }
+    });
+
+    QVector<ItemPtr> shuffled{sample(items, reorderCount, seed)};
+    QVector<ItemPtr> selection{};
+    harness.run(
+        caseName("orderedlist", "reorder"),
+        count,
+        shuffled.size(),
+        [&]() { tree->reorder(selection); },
+        [&]() { selection = shuffled; });
+}
+
+void benchCacheGrid(Harness &harness, int count) {
+    QVector<QRectF> viewports{makeViewports(count, viewportCount, viewportSize, seed)};
+
+    // cells without an image cost next to nothing, so the whole board fits
+    CacheGrid grid{std::numeric_limits<qint64>::max()};
+    grid.queryCells(boardRect(count).toAlignedRect());
+
+    harness.run(caseName("cachegrid", "lookup"), count, viewports.size(), [&]() {
+        for (const QRectF &viewport : viewports) {
+            grid.queryCells(viewport.toAlignedRect());
+        }
+    });
+
+    // a budget of a few cells, so every allocation evicts another cell
+    QSize cellSize{CacheCell::cellSize()};
+    CacheGrid smallGrid{4 * qint64{cellSize.width()} * cellSize.height() * 4};
+
+    qint64 allocations{0};
+    for (const QRectF &viewport : viewports) {
+        allocations += smallGrid.queryCells(viewport.toAlignedRect()).size();
+    }
+
+    harness.run(caseName("cachegrid", "evict"), count, allocations, [&]() {
+        for (const QRectF &viewport : viewports) {
+            for (const auto &cell : smallGrid.queryCells(viewport.toAlignedRect())) {
+                smallGrid.allocate(*cell);
+            }
+        }
+    });
+}
+
+void benchFreeform(Harness &harness, int count) {
+    QVector<ItemPtr> items{makeStrokes(count, pointsPerStroke, seed)};
+
+    // a small rectangle, the size of an eraser, in the middle of each stroke
+    harness.run(caseName("freeform", "intersects-rect"), count, count, [&]() {
+        for (const ItemPtr &item : items) {
+            QPointF center{item->boundingBox().center()};
+            item->intersects(QRectF{center - QPointF{5, 5}, QSizeF{10, 10}});
+        }
+    });
+
+    harness.run(caseName("freeform", "intersects-line"), count, count, [&]() {
+        for (const ItemPtr &item : items) {
+            QRectF box{item->boundingBox()};
+            item->intersects(QLineF{box.topLeft(), box.bottomRight()});
+        }
+    });
+}
+
+void benchSegments(Harness &harness, int count) {
+    using namespace Common::Utils::Segments;
+
+    QVector<SegmentProbe> probes{};
+    for (const ItemPtr &item : makeStrokes(count, pointsPerStroke, seed)) {
+        SegmentProbe probe{std::static_pointer_cast<FreeformItem>(item)->points()};
+        if (probe.make(seed + probes.size()))
+            probes.push_back(std::move(probe));
+    }
+
+    // Far away shapes never get past the per segment bounding box test,
+    // misses inside the bounding box of the stroke also run the side tests
+    // on the segments they overlap and hits stop early. Operations are the segments tested,
+    // so ns_per_op is the time per segment and ops_per_second segments per
+    // second.
+    QRectF far{boardRect(count).bottomRight() + QPointF{100, 100}, QSizeF{10, 10}};
+    QLineF farLine{far.topLeft(), far.bottomRight()};
+
+    qsizetype segments{0}, rectHitSegments{0}, lineHitSegments{0};
+    for (const SegmentProbe &probe : probes) {
+        segments += probe.points.size() - 1;
+        rectHitSegments += probe.rectHitSegments;
+        lineHitSegments += probe.lineHitSegments;
+    }
+
+    for (Kernel kernel : {Kernel::Scalar, Kernel::SSE2, Kernel::AVX2}) {
+        if (!supported(kernel))
+            continue;
+
+        auto run = [&](const char *shape, qsizetype operations, auto test) {
+            QString name{QString{"%1-%2"}.arg(shape, kernelName(kernel))};
+            harness.run(caseName("segments", qPrintable(name)), count, operations, [&]() {
+                for (const SegmentProbe &probe : probes) {
+                    test(probe);
+                }
+            });
+        };
+
+        auto call = [&](const SegmentProbe &probe, const auto &shape) {
+            return intersects(probe.points.constData(), probe.points.size(), shape, kernel);
+        };
+
+        run("rect-far", segments, [&](const SegmentProbe &probe) { call(probe, far); });
+        run("rect-miss", segments, [&](const SegmentProbe &probe) { call(probe, probe.rectMiss); });
+        run("rect-hit", rectHitSegments, [&](const SegmentProbe &probe) {
+            call(probe, probe.rectHit);
+        });
+
+        run("line-far", segments, [&](const SegmentProbe &probe) { call(probe, farLine); });
+        run("line-miss", segments, [&](const SegmentProbe &probe) { call(probe, probe.lineMiss); });
+        run("line-hit", lineHitSegments, [&](const SegmentProbe &probe) {
+            call(probe, probe.lineHit);
+        });
+    }
+}
+
+void benchSerializer(Harness &harness, ApplicationContext *context, int count) {
+    loadBoard(context, count);
+
+    harness.run(caseName("serializer", "write"), count, count, [&]() {
+        Serializer serializer{};
+        serializer.serialize(context);
+
+        QBuffer buffer{};
+        buffer.open(QIODevice::WriteOnly);
+        serializer.write(&buffer);
+    });
+
+    QTemporaryDir dir{};
+    QString filePath{dir.filePath("board.drawy")};
+
+    Serializer serializer{};
+    serializer.serialize(context);
+    if (!serializer.writeToFile(filePath))
+        return;
+
+    Journal &journal{context->uiContext().changesTracker().journal()};
+    harness.run(
+        caseName("loader", "read"),
+        count,
+        count,
+        [&]() {
+            QEventLoop loop{};
+            LoadJob *job{new LoadJob{context, filePath}};
+            QObject::connect(job, &LoadJob::finished, &loop, &QEventLoop::quit);
+            job->start();
+            loop.exec();
+        },
+        [&]() {
+            // loading opens a journal, which would be replayed next time
+            journal.close();
+            QFile::remove(Journal::filePath(filePath));
+        });
+
+    journal.close();
+}
+
+void benchRender(Harness &harness, ApplicationContext *context, int count) {
+    loadBoard(context, count);
+
+    RenderingContext &renderingContext{context->renderingContext()};
+    SpatialContext &spatialContext{context->spatialContext()};
+    QSize canvasSize{renderingContext.canvas().size()};
+
+    auto render = [&](const char *name, qreal zoomFactor, bool dirty) {
+        renderingContext.setZoomFactor(zoomFactor);
+        spatialContext.setOffsetPos(-QPointF{canvasSize.width() / 2.0, canvasSize.height() / 2.0} /
+                                    zoomFactor);
+        Common::renderCanvas(context);
+
+        harness.run(
+            caseName("render", name),
+            count,
+            1,
+            [&]() { Common::renderCanvas(context); },
+            [&]() {
+                if (dirty)
+                    spatialContext.cacheGrid().markAllDirty();
+            });
+    };
+
+    render("full", 1, true);
+    render("cached", 1, false);
+    render("zoomed-out", 0.25, true);
+
+    renderingContext.setZoomFactor(1);
+}
+
+bool checkRecords() {
+    BoardSpec spec{};
+    spec.strokes = 64;
+    spec.shapes = 64;
+    spec.texts = 64;
+    spec.seed = seed;
+
+    int failures{0};
+    for (const ItemPtr &item : makeBoard(spec)) {
+        QRectF before{item->boundingBox()};
+        QRectF after{ItemRecord::fromItem(*item).toItem()->boundingBox()};
+        if (before == after)
+            continue;
+
+        QTextStream{stderr} << QString{"Item of type %1 moved from (%2, %3) to (%4, %5) when "
+                                       "copied through a record\n"}
+                                   .arg(static_cast<int>(item->type()))
+                                   .arg(before.x())
+                                   .arg(before.y())
+                                   .arg(after.x())
+                                   .arg(after.y());
+        failures++;
+    }
+
+    return failures == 0;
+}
+}  // namespace Bench
@@ -0,0 +1,41 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+class ApplicationContext;
+
+namespace Bench {
+class Harness;
+
+// data structures on their own, outside of any context
+void benchQuadTree(Harness &harness, int items);
+void benchOrderedList(Harness &harness, int items);
+void benchCacheGrid(Harness &harness, int items);
+void benchFreeform(Harness &harness, int items);
+void benchSegments(Harness &harness, int items);
+
+// Saving and loading must not move items, every kind of item is copied
+// through an ItemRecord and has to come back with the same bounding box.
+// Mismatches are printed, the result is false if there were any.
+bool checkRecords();
+
+// the board of the application context, which these replace
+void benchSerializer(Harness &harness, ApplicationContext *context, int items);
+void benchRender(Harness &harness, ApplicationContext *context, int items);
+}  // namespace Bench
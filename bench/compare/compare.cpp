@@ -0,0 +1,401 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+#include "../../src/common/utils/compression.hpp"
+#include "../../src/context/applicationcontext.hpp"
+#include "../../src/data-structures/orderedlist.hpp"
+#include "../../src/data-structures/quadtree.hpp"
+#include "../../src/item/freeform.hpp"
+#include "../../src/serializer/loader.hpp"
+#include "../../src/window/window.hpp"
+#include "../harness.hpp"
+
+/*
+ * Before/after benchmarks for the QuadTree, the OrderedList and opening a
+ * file. Unlike drawy_bench this only uses API that every version of the tree
+ * has, so the same cases build on both sides of a change, see compare.sh.
+ */
+namespace {
+using ItemPtr = std::shared_ptr<Item>;
+
+constexpr quint32 seed{0xD7A3};
+constexpr int pointsPerStroke{32};
+constexpr qreal stepLength{4};
+constexpr qreal areaPerItem{200.0 * 200.0};
+constexpr int viewportCount{64};
+constexpr int probeCount{256};
+constexpr int sampleCount{256};
+constexpr int reorderCount{1000};
+constexpr int quadtreeCapacity{100};
+const QSizeF viewportSize{1280, 800};
+const QSizeF probeSize{20, 20};
+
+QString caseName(const char *group, const char *name) {
+    return QString{"%1/%2"}.arg(group, name);
+}
+
+int fail(const QString &message) {
+    QTextStream{stderr} << message << "\n";
+    return 1;
+}
+
+// same density as the boards of drawy_bench
+QRectF boardRect(int count) {
+    qreal side{std::sqrt(std::max(count, 1) * areaPerItem)};
+    return QRectF{-side / 2, -side / 2, side, side};
+}
+
+QPointF randomPoint(const QRectF &rect, QRandomGenerator &random) {
+    return QPointF{rect.left() + random.bounded(rect.width()),
+                   rect.top() + random.bounded(rect.height())};
+}
+
+// random walks, built point by point as both sides can do it
+QVector<QVector<QPointF>> makeWalks(int count) {
+    QRandomGenerator random{seed};
+    QRectF rect{boardRect(count)};
+
+    QVector<QVector<QPointF>> walks{};
+    walks.reserve(count);
+    for (int i{0}; i < count; i++) {
+        QVector<QPointF> points{};
+        points.reserve(pointsPerStroke);
+
+        QPointF point{randomPoint(rect, random)};
+        qreal angle{random.bounded(2 * M_PI)};
+        for (int j{0}; j < pointsPerStroke; j++) {
+            points.push_back(point);
+            angle += random.bounded(0.6) - 0.3;
+            point += QPointF{std::cos(angle), std::sin(angle)} * stepLength;
+        }
+
+        walks.push_back(points);
+    }
+
+    return walks;
+}
+
+QVector<ItemPtr> makeStrokes(const QVector<QVector<QPointF>> &walks) {
+    QVector<ItemPtr> items{};
+    items.reserve(walks.size());
+    for (const QVector<QPointF> &points : walks) {
+        auto item{std::make_shared<FreeformItem>()};
+        for (const QPointF &point : points) {
+            item->addPoint(point, 1.0, false);
+        }
+        items.push_back(item);
+    }
+
+    return items;
+}
+
+QVector<QRectF> makeRects(int count, int rectCount, const QSizeF &size) {
+    QRandomGenerator random{seed};
+    QRectF rect{boardRect(count)};
+
+    QVector<QRectF> rects{};
+    rects.reserve(rectCount);
+    for (int i{0}; i < rectCount; i++) {
+        QPointF center{randomPoint(rect, random)};
+        rects.push_back(QRectF{center - QPointF{size.width(), size.height()} / 2, size});
+    }
+
+    return rects;
+}
+
+QVector<ItemPtr> sample(const QVector<ItemPtr> &items, int count) {
+    QVector<ItemPtr> out{items};
+    QRandomGenerator random{seed};
+    std::shuffle(out.begin(), out.end(), random);
+    out.resize(std::min<qsizetype>(count, out.size()));
+    return out;
+}
+
+std::unique_ptr<QuadTree> makeTree(const QVector<ItemPtr> &items,
+                                   const std::shared_ptr<OrderedList> &orderedList) {
+    auto tree{std::make_unique<QuadTree>(QRectF{QPointF{0, 0}, viewportSize},
+                                         quadtreeCapacity,
+                                         orderedList)};
+    for (const ItemPtr &item : items) {
+        tree->insertItem(item);
+    }
+    return tree;
+}
+
+// a board in the JSON format, which every version of the loader reads
+bool writeJsonBoard(const QString &filePath, const QVector<QVector<QPointF>> &walks) {
+    QJsonArray items{};
+    for (const QVector<QPointF> &points : walks) {
+        QJsonArray pointsArray{}, pressures{};
+        for (const QPointF &point : points) {
+            pointsArray.append(QJsonObject{{"x", point.x()}, {"y", point.y()}});
+            pressures.append(1.0);
+        }
+
+        items.append(QJsonObject{{"type", static_cast<int>(Item::Freeform)},
+                                 {"points", pointsArray},
+                                 {"pressures", pressures},
+                                 {"properties", QJsonArray{}}});
+    }
+
+    QJsonObject board{{"items", items},
+                      {"zoom_factor", 1.0},
+                      {"offset_pos", QJsonObject{{"x", 0.0}, {"y", 0.0}}}};
+    QByteArray data{Common::Utils::Compression::compressData(
+        QJsonDocument{board}.toJson(QJsonDocument::Compact))};
+
+    QFile file{filePath};
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+void benchQuadTree(Bench::Harness &harness, int count) {
+    QVector<ItemPtr> items{makeStrokes(makeWalks(count))};
+    QRectF initialRect{QPointF{0, 0}, viewportSize};
+
+    harness.run(caseName("quadtree", "insert"), count, count, [&]() {
+        QuadTree tree{initialRect, quadtreeCapacity, std::make_shared<OrderedList>()};
+        for (const ItemPtr &item : items) {
+            tree.insertItem(item);
+        }
+    });
+
+    std::unique_ptr<QuadTree> tree{makeTree(items, std::make_shared<OrderedList>())};
+
+    QVector<QRectF> viewports{makeRects(count, viewportCount, viewportSize)};
+    harness.run(caseName("quadtree", "query"), count, viewports.size(), [&]() {
+        for (const QRectF &viewport : viewports) {
+            tree->queryItems(viewport);
+        }
+    });
+
+    // eraser sized rects, these find few items so the fixed cost of a query shows
+    QVector<QRectF> probes{makeRects(count, probeCount, probeSize)};
+    harness.run(caseName("quadtree", "query-small"), count, probes.size(), [&]() {
+        for (const QRectF &probe : probes) {
+            tree->queryItems(probe);
+        }
+    });
+}
+
+void benchOrderedList(Bench::Harness &harness, int count) {
+    QVector<ItemPtr> items{makeStrokes(makeWalks(count))};
+    auto orderedList{std::make_shared<OrderedList>()};
+    std::unique_ptr<QuadTree> tree{makeTree(items, orderedList)};
+
+    QVector<ItemPtr> sampled{sample(items, sampleCount)};
+    harness.run(caseName("orderedlist", "bringtofront"), count, sampled.size(), [&]() {
+        for (const ItemPtr &item : sampled) {
+            orderedList->bringToFront(item);
+        }
+    });
+
+    harness.run(caseName("orderedlist", "sendtoback"), count, sampled.size(), [&]() {
+        for (const ItemPtr &item : sampled) {
+            orderedList->sendToBack(item);
+        }
+    });
+
+    QVector<ItemPtr> shuffled{sample(items, reorderCount)};
+    QVector<ItemPtr> selection{};
+    harness.run(
+        caseName("orderedlist", "reorder"),
+        count,
+        shuffled.size(),
+        [&]() { tree->reorder(selection); },
+        [&]() { selection = shuffled; });
+
+    // sorts the result of a viewport query, as drawing does
+    QVector<ItemPtr> visible{tree->queryItems(makeRects(count, 1, viewportSize).front())};
+    QRandomGenerator random{seed};
+    harness.run(
+        caseName("orderedlist", "reorder-viewport"),
+        count,
+        visible.size(),
+        [&]() { tree->reorder(selection); },
+        [&]() {
+            selection = visible;
+            std::shuffle(selection.begin(), selection.end(), random);
+        });
+}
+
+void benchOpen(Bench::Harness &harness, ApplicationContext *context, int count) {
+    if (!harness.selected(caseName("loader", "open-json")))
+        return;
+
+    QTemporaryDir dir{};
+    QString filePath{dir.filePath("board.drawy")};
+    if (!writeJsonBoard(filePath, makeWalks(count))) {
+        QTextStream{stderr} << "Could not write " << filePath << "\n";
+        return;
+    }
+
+    harness.run(caseName("loader", "open-json"), count, count, [&]() {
+        Loader loader{};
+        loader.loadFromFilePath(context, filePath);
+    });
+
+    context->reset();
+}
+
+struct Entry {
+    int items{};
+    double nsPerOp{};
+};
+
+// name and board size to time per operation
+bool readReport(const QString &filePath, QVector<QString> &order, QHash<QString, Entry> &out) {
+    QFile file{filePath};
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QJsonDocument doc{QJsonDocument::fromJson(file.readAll())};
+    if (!doc.isObject())
+        return false;
+
+    for (const QJsonValue &value : doc.object().value("benchmarks").toArray()) {
+        QJsonObject entry{value.toObject()};
+        int items{entry.value("items").toInt()};
+        QString key{QString{"%1 [%2]"}.arg(entry.value("name").toString()).arg(items)};
+
+        if (!out.contains(key))
+            order.push_back(key);
+        out[key] = Entry{items, entry.value("ns_per_op").toDouble()};
+    }
+
+    return true;
+}
+
+// prints a table of two reports, the speedup is before / after
+int diff(const QString &beforePath, const QString &afterPath) {
+    QVector<QString> order{}, afterOrder{};
+    QHash<QString, Entry> before{}, after{};
+    if (!readReport(beforePath, order, before))
+        return fail(QString{"Could not read %1"}.arg(beforePath));
+    if (!readReport(afterPath, afterOrder, after))
+        return fail(QString{"Could not read %1"}.arg(afterPath));
+
+    QTextStream out{stdout};
+    out << QString{"%1 %2 %3 %4\n"}
+               .arg("benchmark", -36)
+               .arg("before ns/op", 14)
+               .arg("after ns/op", 14)
+               .arg("speedup", 9);
+
+    for (const QString &key : order) {
+        if (!after.contains(key))
+            continue;
+
+        double beforeNs{before[key].nsPerOp}, afterNs{after[key].nsPerOp};
+        out << QString{"%1 %2 %3 %4x\n"}
+                   .arg(key, -36)
+                   .arg(beforeNs, 14, 'f', 1)
+                   .arg(afterNs, 14, 'f', 1)
+                   .arg(beforeNs / std::max(afterNs, 1e-3), 8, 'f', 2);
+    }
+
+    return 0;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QStandardPaths::setTestModeEnabled(true);
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QApplication app{argc, argv};
+    QApplication::setApplicationName("drawy_compare");
+
+    QCommandLineParser parser{};
+    parser.setApplicationDescription(
+        "Benchmarks the QuadTree, the OrderedList and opening files with the API "
+        "shared by every version, to compare two builds");
+    parser.addHelpOption();
+    parser.addOptions({
+        {{"o", "output"}, "Write the JSON report to <file> instead of stdout.", "file"},
+        {{"f", "filter"},
+         "Only run benchmarks whose name contains <name>, can be repeated.",
+         "name"},
+        {{"s", "sizes"}, "Comma separated board sizes.", "sizes", "1000,10000,100000"},
+        {"min-time", "Minimum time spent on each benchmark.", "ms", "500"},
+        {"diff", "Print the reports <before> and <after> side by side and exit.", "before"},
+    });
+    parser.addPositionalArgument("after", "The report to compare with --diff.");
+    parser.process(app);
+
+    if (parser.isSet("diff")) {
+        if (parser.positionalArguments().size() != 1)
+            return fail("--diff needs the report of the build to compare with");
+
+        return diff(parser.value("diff"), parser.positionalArguments().front());
+    }
+
+    QVector<int> sizes{};
+    for (const QString &size : parser.value("sizes").split(',', Qt::SkipEmptyParts)) {
+        bool ok{};
+        int value{size.trimmed().toInt(&ok)};
+        if (!ok || value <= 0)
+            return fail(QString{"Invalid board size: %1"}.arg(size));
+
+        sizes.push_back(value);
+    }
+
+    MainWindow window{};
+    window.resize(1280, 800);
+    window.show();
+    QApplication::processEvents();
+
+    ApplicationContext *context{ApplicationContext::instance()};
+    Bench::Harness harness{parser.values("filter"), parser.value("min-time").toLongLong()};
+
+    for (int size : sizes) {
+        benchQuadTree(harness, size);
+        benchOrderedList(harness, size);
+        benchOpen(harness, context, size);
+    }
+
+    QByteArray report{harness.toJson().toJson()};
+    if (!parser.isSet("output")) {
+        QTextStream{stdout} << report;
+        return 0;
+    }
+
+    QFile file{parser.value("output")};
+    if (!file.open(QIODevice::WriteOnly) || file.write(report) != report.size())
+        return fail(QString{"Could not write %1"}.arg(file.fileName()));
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#!/usr/bin/env bash
+#
+# Builds drawy_compare at two revisions and prints their results side by side.
+#
+#   bench/compare/compare.sh <before> [<after>] [drawy_compare options...]
+#
+# <after> defaults to HEAD. The revisions are checked out into temporary git
+# worktrees, the current copy of bench/compare is built against each of them
+# so both sides run the same cases. The reports are kept as
+# compare-before.json and compare-after.json in the working directory.
+#
+# e.g. bench/compare/compare.sh HEAD~4 HEAD --sizes 100000 --filter quadtree
+
+set -euo pipefail
+
+if [[ $# -lt 1 || $1 == -* ]]; then
+    sed -n '3,13p' "$0" | cut -c3-
+    exit 1
+fi
+
+before=$1
+shift
+after=HEAD
+if [[ $# -gt 0 && $1 != -* ]]; then
+    after=$1
+    shift
+fi
+
+root=$(git rev-parse --show-toplevel)
+bench=$root/bench
+work=$(mktemp -d)
+
+cleanup() {
+    git -C "$root" worktree remove --force "$work/before" 2>/dev/null || true
+    git -C "$root" worktree remove --force "$work/after" 2>/dev/null || true
+    rm -rf "$work"
+}
+trap cleanup EXIT
+
+for side in before after; do
+    if [[ $side == before ]]; then rev=$before; else rev=$after; fi
+    tree=$work/$side
+
+    git -C "$root" worktree add --detach --quiet "$tree" "$rev"
+
+    # the same layout as in bench/, so the relative includes resolve
+    mkdir -p "$tree/bench-compare"
+    cp -r "$bench/compare" "$tree/bench-compare/"
+    cp "$bench/harness.cpp" "$bench/harness.hpp" "$tree/bench-compare/"
+    echo 'add_subdirectory(bench-compare/compare)' >>"$tree/CMakeLists.txt"
+
+    cmake -S "$tree" -B "$work/build-$side" -DCMAKE_BUILD_TYPE=Release >/dev/null
+    cmake --build "$work/build-$side" --target drawy_compare -j"$(nproc)" >/dev/null
+
+    echo "Running $rev ($side)" >&2
+    "$work/build-$side/bench-compare/compare/drawy_compare" --output "compare-$side.json" "$@"
+done
+
+"$work/build-after/bench-compare/compare/drawy_compare" --diff compare-before.json compare-after.json
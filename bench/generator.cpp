@@ -0,0 +1,122 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCommandLineParser>
+#include <QGuiApplication>
+#include <QHash>
+#include <QLoggingCategory>
+#include <QStandardPaths>
+#include <QTextStream>
+
+#include "../src/common/utils/compression.hpp"
+#include "../src/serializer/serializer.hpp"
+#include "syntheticboard.hpp"
+
+namespace {
+using Preset = Common::Utils::Compression::Profile::Preset;
+
+int fail(const QString &message) {
+    QTextStream{stderr} << message << "\n";
+    return 1;
+}
+
+bool readCount(const QCommandLineParser &parser, const QString &name, int &out) {
+    bool ok{};
+    out = parser.value(name).toInt(&ok);
+    return ok && out >= 0;
+}
+}  // namespace
+
+/*
+ * Writes a synthetic .drawy board for load and performance testing. The output
+ * only depends on the arguments: the same seed always gives the same file.
+ */
+int main(int argc, char *argv[]) {
+    // text items need fonts, but nothing is ever shown
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    // keeps the user's compression settings out of the output
+    QStandardPaths::setTestModeEnabled(true);
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QGuiApplication app{argc, argv};
+    QGuiApplication::setApplicationName("drawy_gen");
+
+    QCommandLineParser parser{};
+    parser.setApplicationDescription("Generates synthetic Drawy boards");
+    parser.addHelpOption();
+    parser.addPositionalArgument("file", "The .drawy file to write.");
+    parser.addOptions({
+        {"strokes", "Number of freeform strokes.", "n", "10000"},
+        {"points", "Number of points per stroke.", "m", "32"},
+        {"shapes", "Number of rectangles, ellipses, lines and arrows.", "n", "0"},
+        {"texts", "Number of text items.", "n", "0"},
+        {"distribution", "Item placement, uniform or clustered.", "type", "uniform"},
+        {"clusters", "Number of clusters of a clustered board.", "n", "16"},
+        {"seed", "Seed of the random generator.", "seed", "1"},
+        {"preset", "Compression preset, standard, fast or dense.", "preset", "standard"},
+    });
+    parser.process(app);
+
+    const QStringList arguments{parser.positionalArguments()};
+    if (arguments.size() != 1) {
+        parser.showHelp(1);
+    }
+
+    Bench::BoardSpec spec{};
+    if (!readCount(parser, "strokes", spec.strokes) ||
+        !readCount(parser, "points", spec.pointsPerStroke) ||
+        !readCount(parser, "shapes", spec.shapes) || !readCount(parser, "texts", spec.texts) ||
+        !readCount(parser, "clusters", spec.clusters)) {
+        return fail("Counts must be non-negative integers");
+    }
+
+    bool ok{};
+    spec.seed = parser.value("seed").toUInt(&ok);
+    if (!ok) {
+        return fail("Invalid seed: " + parser.value("seed"));
+    }
+
+    const QHash<QString, Bench::BoardSpec::Distribution> distributions{
+        {"uniform", Bench::BoardSpec::Uniform},
+        {"clustered", Bench::BoardSpec::Clustered}};
+    if (!distributions.contains(parser.value("distribution"))) {
+        return fail("Unknown distribution: " + parser.value("distribution"));
+    }
+    spec.distribution = distributions[parser.value("distribution")];
+
+    const QHash<QString, Preset> presets{{"standard", Preset::Standard},
+                                         {"fast", Preset::Fast},
+                                         {"dense", Preset::Dense}};
+    if (!presets.contains(parser.value("preset"))) {
+        return fail("Unknown preset: " + parser.value("preset"));
+    }
+
+    Serializer serializer{};
+    serializer.setPreset(presets[parser.value("preset")]);
+    serializer.serialize(Bench::makeBoard(spec), QPointF{0, 0}, 1, spec.seed);
+
+    if (!serializer.writeToFile(arguments.first())) {
+        return fail("Could not write " + arguments.first());
+    }
+
+    QTextStream{stdout} << "Wrote " << spec.items() << " items to " << arguments.first() << "\n";
+    return 0;
+}
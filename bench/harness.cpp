@@ -0,0 +1,126 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "harness.hpp"
+
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QThread>
+#include <QTextStream>
+#include <algorithm>
+#include <limits>
+
+namespace {
+constexpr qint64 minIterations{3};
+constexpr qint64 maxIterations{1'000'000};
+}  // namespace
+
+namespace Bench {
+Harness::Harness(const QStringList &filters, qint64 minTimeMs)
+    : m_filters{filters},
+      m_minTimeNs{minTimeMs * 1'000'000} {
+}
+
+bool Harness::selected(const QString &name) const {
+    if (m_filters.empty())
+        return true;
+
+    return std::any_of(m_filters.begin(), m_filters.end(), [&](const QString &filter) {
+        return name.contains(filter);
+    });
+}
+
+void Harness::run(const QString &name,
+                  int items,
+                  qint64 operations,
+                  const std::function<void()> &body,
+                  const std::function<void()> &setup) {
+    if (!selected(name))
+        return;
+
+    Result result{name, items, 0, std::max<qint64>(operations, 1)};
+    result.minNs = std::numeric_limits<double>::max();
+
+    QElapsedTimer timer{};
+    qint64 total{0};
+    while ((total < m_minTimeNs || result.iterations < minIterations) &&
+           result.iterations < maxIterations) {
+        if (setup)
+            setup();
+
+        timer.start();
+        body();
+        qint64 elapsed{timer.nsecsElapsed()};
+
+        total += elapsed;
+        result.iterations++;
+        result.minNs = std::min(result.minNs, static_cast<double>(elapsed));
+        result.maxNs = std::max(result.maxNs, static_cast<double>(elapsed));
+    }
+
+    result.meanNs = static_cast<double>(total) / result.iterations;
+    m_results.push_back(result);
+
+    QTextStream{stderr} << QString{"%1 [%2]: %3 ms mean, %4 ns/op\n"}
+                               .arg(name)
+                               .arg(items)
+                               .arg(result.meanNs / 1e6, 0, 'f', 3)
+                               .arg(result.meanNs / result.operations, 0, 'f', 1);
+}
+
+const QVector<Result> &Harness::results() const {
+    return m_results;
+}
+
+QJsonDocument Harness::toJson() const {
+    QJsonObject context{};
+    context["cpu"] = QSysInfo::currentCpuArchitecture();
+    context["os"] = QSysInfo::prettyProductName();
+    context["qt"] = QString{qVersion()};
+    context["threads"] = QThread::idealThreadCount();
+    context["platform"] = QGuiApplication::platformName();
+#ifdef NDEBUG
+    context["build"] = "release";
+#else
+    context["build"] = "debug";
+#endif
+
+    QJsonArray benchmarks{};
+    for (const Result &result : m_results) {
+        QJsonObject entry{};
+        entry["name"] = result.name;
+        entry["items"] = result.items;
+        entry["iterations"] = result.iterations;
+        entry["operations"] = result.operations;
+        entry["mean_ns"] = result.meanNs;
+        entry["min_ns"] = result.minNs;
+        entry["max_ns"] = result.maxNs;
+        entry["ns_per_op"] = result.meanNs / result.operations;
+        entry["ops_per_second"] = 1e9 * result.operations / std::max(result.meanNs, 1.0);
+        benchmarks.append(entry);
+    }
+
+    QJsonObject root{};
+    root["context"] = context;
+    root["benchmarks"] = benchmarks;
+    return QJsonDocument{root};
+}
+}  // namespace Bench
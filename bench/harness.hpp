@@ -0,0 +1,65 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QJsonDocument>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+
+namespace Bench {
+struct Result {
+    QString name{};
+    int items{};
+    qint64 iterations{};
+    qint64 operations{};  // per iteration
+    double meanNs{};
+    double minNs{};
+    double maxNs{};
+};
+
+/*
+ * A deliberately small benchmark runner. Every case is run until it has taken
+ * at least the minimum time (and at least a few iterations), each iteration
+ * is timed on its own so that the optional setup can stay out of the numbers.
+ */
+class Harness {
+public:
+    Harness(const QStringList &filters, qint64 minTimeMs);
+
+    bool selected(const QString &name) const;
+
+    // `operations` is how many operations one call to `body` performs, the
+    // report includes the time per operation as well
+    void run(const QString &name,
+             int items,
+             qint64 operations,
+             const std::function<void()> &body,
+             const std::function<void()> &setup = {});
+
+    const QVector<Result> &results() const;
+    QJsonDocument toJson() const;
+
+private:
+    QStringList m_filters{};
+    qint64 m_minTimeNs{};
+    QVector<Result> m_results{};
+};
+}  // namespace Bench
@@ -0,0 +1,106 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QStandardPaths>
+#include <QTextStream>
+
+#include "../src/context/applicationcontext.hpp"
+#include "../src/window/window.hpp"
+#include "benchmarks.hpp"
+#include "harness.hpp"
+
+/*
+ * Runs the benchmarks headless against a real (hidden) window, so the canvas
+ * and contexts are set up exactly as in the application, and prints the
+ * results as JSON. Settings and autosaves go to the test locations of
+ * QStandardPaths, the user's files are never touched.
+ */
+int main(int argc, char *argv[]) {
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QStandardPaths::setTestModeEnabled(true);
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QApplication app{argc, argv};
+    QApplication::setApplicationName("drawy_bench");
+
+    QCommandLineParser parser{};
+    parser.setApplicationDescription("Benchmarks the core data structures and rendering of Drawy");
+    parser.addHelpOption();
+    parser.addOptions({
+        {{"o", "output"}, "Write the JSON report to <file> instead of stdout.", "file"},
+        {{"f", "filter"},
+         "Only run benchmarks whose name contains <name>, can be repeated.",
+         "name"},
+        {{"s", "sizes"}, "Comma separated board sizes.", "sizes", "1000,10000,100000"},
+        {"min-time", "Minimum time spent on each benchmark.", "ms", "500"},
+    });
+    parser.process(app);
+
+    QVector<int> sizes{};
+    for (const QString &size : parser.value("sizes").split(',', Qt::SkipEmptyParts)) {
+        bool ok{};
+        int value{size.trimmed().toInt(&ok)};
+        if (!ok || value <= 0) {
+            QTextStream{stderr} << "Invalid board size: " << size << "\n";
+            return 1;
+        }
+        sizes.push_back(value);
+    }
+
+    MainWindow window{};
+    window.resize(1280, 800);
+    window.show();
+    QApplication::processEvents();
+
+    ApplicationContext *context{ApplicationContext::instance()};
+    if (!Bench::checkRecords())
+        return 1;
+
+    Bench::Harness harness{parser.values("filter"), parser.value("min-time").toLongLong()};
+
+    for (int size : sizes) {
+        Bench::benchQuadTree(harness, size);
+        Bench::benchOrderedList(harness, size);
+        Bench::benchCacheGrid(harness, size);
+        Bench::benchFreeform(harness, size);
+        Bench::benchSegments(harness, size);
+        Bench::benchSerializer(harness, context, size);
+        Bench::benchRender(harness, context, size);
+    }
+
+    QByteArray report{harness.toJson().toJson()};
+    if (!parser.isSet("output")) {
+        QTextStream{stdout} << report;
+        return 0;
+    }
+
+    QFile file{parser.value("output")};
+    if (!file.open(QIODevice::WriteOnly) || file.write(report) != report.size()) {
+        QTextStream{stderr} << "Could not write " << file.fileName() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "syntheticboard.hpp"
+
+#include <QColor>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+#include "../src/item/arrow.hpp"
+#include "../src/item/ellipse.hpp"
+#include "../src/item/freeform.hpp"
+#include "../src/item/line.hpp"
+#include "../src/item/rectangle.hpp"
+#include "../src/item/text.hpp"
+
+namespace {
+// roughly one item per 200x200 pixels
+constexpr qreal areaPerItem{200.0 * 200.0};
+constexpr qreal stepLength{4.0};
+constexpr qreal minShapeSize{20.0};
+constexpr qreal maxShapeSize{300.0};
+constexpr int maxWords{8};
+
+enum class Kind { Stroke, Shape, Text };
+
+const QVector<QColor> &palette() {
+    static const QVector<QColor> colors{QColor{Qt::black},
+                                        QColor{Qt::white},
+                                        QColor{"#e03131"},
+                                        QColor{"#2f9e44"},
+                                        QColor{"#1971c2"},
+                                        QColor{"#f08c00"}};
+    return colors;
+}
+
+const QStringList &words() {
+    static const QStringList list{"idea", "draft", "todo",   "review", "sketch", "note",
+                                  "plan", "later", "maybe",  "check",  "layout", "flow",
+                                  "user", "data",  "render", "cache",  "board",  "arrow"};
+    return list;
+}
+
+// Picks item positions, either uniformly over the board or normally
+// distributed around a few cluster centers.
+class Placer {
+public:
+    Placer(const Bench::BoardSpec &spec, QRandomGenerator &random)
+        : m_random{random},
+          m_rect{Bench::boardRect(spec.items())} {
+        if (spec.distribution != Bench::BoardSpec::Clustered)
+            return;
+
+        int clusters{std::max(spec.clusters, 1)};
+        for (int i{0}; i < clusters; i++) {
+            m_centers.push_back(uniform());
+        }
+
+        // clusters cover about a quarter of the board between them
+        m_spread = m_rect.width() / (4 * std::sqrt(static_cast<qreal>(clusters)));
+    }
+
+    QPointF next() {
+        if (m_centers.empty())
+            return uniform();
+
+        const QPointF &center{m_centers[m_random.bounded(static_cast<int>(m_centers.size()))]};
+        return center + QPointF{normal(), normal()} * m_spread;
+    }
+
+private:
+    QPointF uniform() {
+        return QPointF{m_rect.left() + m_random.bounded(m_rect.width()),
+                       m_rect.top() + m_random.bounded(m_rect.height())};
+    }
+
+    // Box-Muller
+    qreal normal() {
+        qreal u{1.0 - m_random.generateDouble()};
+        qreal v{m_random.generateDouble()};
+        return std::sqrt(-2 * std::log(u)) * std::cos(2 * M_PI * v);
+    }
+
+    QRandomGenerator &m_random;
+    QRectF m_rect{};
+    QVector<QPointF> m_centers{};
+    qreal m_spread{};
+};
+
+void setStyle(Item &item, QRandomGenerator &random) {
+    const QVector<QColor> &colors{palette()};
+    item.setProperty(Property::StrokeColor,
+                     Property{colors[random.bounded(static_cast<int>(colors.size()))],
+                              Property::StrokeColor});
+    item.setProperty(Property::StrokeWidth, Property{1 << random.bounded(3), Property::StrokeWidth});
+}
+
+std::shared_ptr<Item> makeStroke(QPointF point, int pointsPerStroke, QRandomGenerator &random) {
+    auto item{std::make_shared<FreeformItem>()};
+    setStyle(*item, random);
+
+    QVector<QPointF> points{};
+    QVector<qreal> pressures{};
+    points.reserve(pointsPerStroke);
+    pressures.reserve(pointsPerStroke);
+
+    qreal angle{random.bounded(2 * M_PI)};
+    for (int i{0}; i < pointsPerStroke; i++) {
+        points.push_back(point);
+        pressures.push_back(0.5 + random.bounded(0.5));
+
+        angle += random.bounded(0.6) - 0.3;
+        point += QPointF{std::cos(angle), std::sin(angle)} * stepLength;
+    }
+
+    item->setPoints(points, pressures);
+    return item;
+}
+
+std::shared_ptr<Item> makeShape(const QPointF &point, QRandomGenerator &random) {
+    std::shared_ptr<PolygonItem> item{};
+    switch (random.bounded(4)) {
+        case 0:
+            item = std::make_shared<RectangleItem>();
+            break;
+        case 1:
+            item = std::make_shared<EllipseItem>();
+            break;
+        case 2:
+            item = std::make_shared<LineItem>();
+            break;
+        default:
+            item = std::make_shared<ArrowItem>();
+            break;
+    }
+    setStyle(*item, random);
+
+    QPointF size{minShapeSize + random.bounded(maxShapeSize - minShapeSize),
+                 minShapeSize + random.bounded(maxShapeSize - minShapeSize)};
+    item->setStart(point);
+    item->setEnd(point + size);
+    return item;
+}
+
+std::shared_ptr<Item> makeText(const QPointF &point, QRandomGenerator &random) {
+    const QStringList &list{words()};
+
+    QStringList text{};
+    int count{1 + random.bounded(maxWords)};
+    for (int i{0}; i < count; i++) {
+        text.push_back(list[random.bounded(static_cast<int>(list.size()))]);
+    }
+
+    auto item{std::make_shared<TextItem>()};
+    item->createTextBox(point);
+    item->insertText(text.join(' '));
+    return item;
+}
+}  // namespace
+
+namespace Bench {
+int BoardSpec::items() const {
+    return std::max(strokes, 0) + std::max(shapes, 0) + std::max(texts, 0);
+}
+
+QRectF boardRect(int count) {
+    qreal side{std::sqrt(std::max(count, 1) * areaPerItem)};
+    return QRectF{-side / 2, -side / 2, side, side};
+}
+
+QVector<std::shared_ptr<Item>> makeBoard(const BoardSpec &spec) {
+    QRandomGenerator random{spec.seed};
+    Placer placer{spec, random};
+
+    QVector<Kind> kinds{};
+    kinds.reserve(spec.items());
+    kinds.insert(kinds.end(), std::max(spec.strokes, 0), Kind::Stroke);
+    kinds.insert(kinds.end(), std::max(spec.shapes, 0), Kind::Shape);
+    kinds.insert(kinds.end(), std::max(spec.texts, 0), Kind::Text);
+    std::shuffle(kinds.begin(), kinds.end(), random);
+
+    QVector<std::shared_ptr<Item>> items{};
+    items.reserve(kinds.size());
+
+    for (Kind kind : kinds) {
+        QPointF point{placer.next()};
+        switch (kind) {
+            case Kind::Stroke:
+                items.push_back(makeStroke(point, std::max(spec.pointsPerStroke, 1), random));
+                break;
+            case Kind::Shape:
+                items.push_back(makeShape(point, random));
+                break;
+            case Kind::Text:
+                items.push_back(makeText(point, random));
+                break;
+        }
+    }
+
+    return items;
+}
+
+QVector<std::shared_ptr<Item>> makeStrokes(int count, int pointsPerStroke, quint32 seed) {
+    BoardSpec spec{};
+    spec.strokes = count;
+    spec.pointsPerStroke = pointsPerStroke;
+    spec.seed = seed;
+    return makeBoard(spec);
+}
+
+QVector<QRectF> makeViewports(int boardItems, int count, const QSizeF &size, quint32 seed) {
+    QRandomGenerator random{seed};
+    QRectF rect{boardRect(boardItems)};
+
+    QVector<QRectF> viewports{};
+    viewports.reserve(count);
+    for (int i{0}; i < count; i++) {
+        QPointF center{rect.left() + random.bounded(rect.width()),
+                       rect.top() + random.bounded(rect.height())};
+        viewports.push_back(QRectF{center - QPointF{size.width(), size.height()} / 2, size});
+    }
+
+    return viewports;
+}
+}  // namespace Bench
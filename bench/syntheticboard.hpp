@@ -0,0 +1,56 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QRectF>
+#include <QSizeF>
+#include <QVector>
+#include <memory>
+class Item;
+
+namespace Bench {
+struct BoardSpec {
+    enum Distribution { Uniform, Clustered };
+
+    int strokes{1000};
+    int pointsPerStroke{32};
+    int shapes{0};  // rectangles, ellipses, lines and arrows
+    int texts{0};
+    Distribution distribution{Uniform};
+    int clusters{16};
+    quint32 seed{0};
+
+    int items() const;
+};
+
+// The area a board of `count` items is spread over. It grows with the number
+// of items so the density, and with it the work per viewport, stays the same.
+QRectF boardRect(int count);
+
+// Builds the board described by `spec` over boardRect(spec.items()), in a
+// shuffled z-order. The same spec always gives the same board.
+QVector<std::shared_ptr<Item>> makeBoard(const BoardSpec &spec);
+
+// `count` freeform strokes (random walks of `pointsPerStroke` points)
+// scattered uniformly, a shorthand for makeBoard()
+QVector<std::shared_ptr<Item>> makeStrokes(int count, int pointsPerStroke, quint32 seed);
+
+// `count` viewport sized rectangles spread over the board.
+QVector<QRectF> makeViewports(int boardItems, int count, const QSizeF &size, quint32 seed);
+}  // namespace Bench
@@ -19,8 +19,21 @@
 #include "canvas.hpp"
 
 #include <QBuffer>
+#include <QLocale>
 #include <QResizeEvent>
 #include <QScreen>
+#include <algorithm>
+#include <functional>
+
+#include "../common/profiler.hpp"
+
+namespace {
+constexpr int hudWidth{300};
+constexpr int hudMargin{10};
+constexpr int hudPadding{8};
+constexpr int hudScopes{4};  // slowest timers listed
+constexpr int hudLines{2 + Profiler::CounterCount + hudScopes};
+}  // namespace
 
 // PUBLIC
 Canvas::Canvas(QWidget *parent) : QWidget{parent}, m_maxSize(m_sizeHint) {
@@ -101,6 +114,8 @@ QSize Canvas::dimensions() const {
 
 // PROTECTED
 void Canvas::paintEvent(QPaintEvent *event) {
+    ScopedTimer timer{"Canvas::paintEvent"};
+
     QPainter painter{this};
     painter.scale(1.0 / m_scale, 1.0 / m_scale);
     painter.setClipRegion(m_canvas->rect());
@@ -109,6 +124,59 @@ void Canvas::paintEvent(QPaintEvent *event) {
         painter.drawPixmap(0, 0, *m_canvas);
     if (m_overlay)
         painter.drawPixmap(0, 0, *m_overlay);
+
+    if (Profiler::instance().overlayVisible()) {
+        painter.resetTransform();
+        painter.setClipping(false);
+        drawHud(painter);
+    }
+}
+
+QRect Canvas::hudRect() const {
+    int height{hudLines * fontMetrics().height() + 2 * hudPadding};
+    return QRect{width() - hudWidth - hudMargin, hudMargin, hudWidth, height};
+}
+
+void Canvas::drawHud(QPainter &painter) const {
+    Profiler &profiler{Profiler::instance()};
+    Profiler::Frame frame{profiler.lastFrame()};
+    QLocale locale{};
+
+    QStringList lines{};
+    lines.push_back(QString{"Frame: %1 ms (avg %2 ms)"}
+                        .arg(frame.durationNs / 1e6, 0, 'f', 2)
+                        .arg(profiler.averageFrameMs(), 0, 'f', 2));
+    lines.push_back(profiler.tracing() ? "Recording trace" : "");
+
+    for (int counter{0}; counter < Profiler::CounterCount; counter++) {
+        qint64 value{frame.counters[counter]};
+        QString text{counter == Profiler::PixmapBytes ? locale.formattedDataSize(value)
+                                                      : locale.toString(value)};
+        lines.push_back(Profiler::counterName(static_cast<Profiler::Counter>(counter)) + ": " +
+                        text);
+    }
+
+    QVector<std::pair<qint64, QString>> scopes{};
+    for (auto it{frame.scopes.begin()}; it != frame.scopes.end(); it++) {
+        scopes.push_back({it.value(), it.key()});
+    }
+    std::sort(scopes.begin(), scopes.end(), std::greater{});
+    for (qsizetype i{0}; i < std::min<qsizetype>(scopes.size(), hudScopes); i++) {
+        lines.push_back(
+            QString{"%1: %2 ms"}.arg(scopes[i].second).arg(scopes[i].first / 1e6, 0, 'f', 2));
+    }
+
+    QRect rect{hudRect()};
+    painter.save();
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor{0, 0, 0, 180});
+    painter.drawRoundedRect(rect, 6, 6);
+
+    painter.setPen(Qt::white);
+    painter.setFont(font());
+    QRect textRect{rect.adjusted(hudPadding, hudPadding, -hudPadding, -hudPadding)};
+    painter.drawText(textRect, Qt::AlignLeft | Qt::AlignTop, lines.join('\n'));
+    painter.restore();
 }
 
 // just a small overload
@@ -40,6 +40,9 @@ public:
     qreal scale() const;
     void setScale(const qreal scale);
 
+    // where the performance overlay is drawn, see Profiler
+    QRect hudRect() const;
+
 signals:
     void mousePressed(QMouseEvent *event);
     void mouseMoved(QMouseEvent *event);
@@ -86,4 +89,5 @@ private:
     static QByteArray imageData(QPixmap *const img);
     static void setImageData(QPixmap *const img, const QByteArray &arr);
     void resize();
+    void drawHud(QPainter &painter) const;
 };
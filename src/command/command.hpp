@@ -19,10 +19,19 @@
 #pragma once
 
 class ApplicationContext;
+class Journal;
 
 class Command {
 public:
     virtual ~Command() = default;
     virtual void execute(ApplicationContext *context) = 0;
     virtual void undo(ApplicationContext *context) = 0;
+
+    // logs what execute() (or undo() if `undone`) changed in the document,
+    // commands that only change the selection log nothing
+    virtual void journal(Journal &journal, bool undone) const {};
+
+    // called when the command leaves the history for good, in the state that
+    // execute() (or undo() if `undone`) left it in
+    virtual void discard(ApplicationContext *context, bool undone) {};
 };
@@ -38,12 +38,14 @@ void CommandHistory::undo() {
 
     m_redoStack->push_front(lastCommand);
 
-    if (m_redoStack->size() == maxCommands)
+    if (m_redoStack->size() == maxCommands) {
+        m_redoStack->back()->discard(m_context, true);
         m_redoStack->pop_back();
+    }
 
     m_undoStack->pop_front();
     
-    emit commandUndone();
+    emit commandUndone(lastCommand);
 }
 
 void CommandHistory::redo() {
@@ -54,29 +56,42 @@ void CommandHistory::redo() {
     nextCommand->execute(m_context);
 
     m_undoStack->push_front(nextCommand);
-    if (m_undoStack->size() == maxCommands)
+    if (m_undoStack->size() == maxCommands) {
+        m_undoStack->back()->discard(m_context, false);
         m_undoStack->pop_back();
+    }
 
     m_redoStack->pop_front();
     
-    emit commandExecuted();
+    emit commandExecuted(nextCommand);
 }
 
 void CommandHistory::insert(const std::shared_ptr<Command>& command) {
     while (!m_redoStack->empty()) {
+        m_redoStack->front()->discard(m_context, true);
         m_redoStack->pop_front();
     }
 
     command->execute(m_context);
 
     m_undoStack->push_front(command);
-    if (m_undoStack->size() == maxCommands)
+    if (m_undoStack->size() == maxCommands) {
+        m_undoStack->back()->discard(m_context, false);
         m_undoStack->pop_back();
+    }
     
-    emit commandExecuted();
+    emit commandExecuted(command);
 }
 
 void CommandHistory::clear() {
+    for (const auto &command : *m_undoStack) {
+        command->discard(m_context, false);
+    }
+
+    for (const auto &command : *m_redoStack) {
+        command->discard(m_context, true);
+    }
+
     m_undoStack->clear();
     m_redoStack->clear();
 }
\ No newline at end of file
@@ -41,8 +41,8 @@ public:
     void clear();
 
 signals:
-    void commandExecuted();
-    void commandUndone();
+    void commandExecuted(const std::shared_ptr<Command> &command);
+    void commandUndone(const std::shared_ptr<Command> &command);
 
 private:
     std::unique_ptr<std::deque<std::shared_ptr<Command>>> m_undoStack;
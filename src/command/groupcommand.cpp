@@ -30,6 +30,7 @@
 #include "../data-structures/cachegrid.hpp"
 #include "../data-structures/quadtree.hpp"
 #include "../item/group.hpp"
+#include "../serializer/journal.hpp"
 
 GroupCommand::GroupCommand(QVector<std::shared_ptr<Item>> items) : ItemCommand{std::move(items)} {
     m_group = std::make_shared<GroupItem>();
@@ -69,3 +70,18 @@ void GroupCommand::undo(ApplicationContext *context) {
 
     context->spatialContext().cacheGrid().markDirty(m_group->boundingBox().toRect());
 }
+
+void GroupCommand::journal(Journal &journal, bool undone) const {
+    if (undone) {
+        journal.remove(*m_group);
+        for (const auto &item : m_items) {
+            journal.update(*item);
+        }
+        return;
+    }
+
+    for (const auto &item : m_items) {
+        journal.remove(*item);
+    }
+    journal.insert(*m_group);
+}
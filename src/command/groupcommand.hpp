@@ -29,6 +29,7 @@ public:
 
     void execute(ApplicationContext *context) override;
     void undo(ApplicationContext *context) override;
+    void journal(Journal &journal, bool undone) const override;
 
 private:
     std::shared_ptr<GroupItem> m_group;
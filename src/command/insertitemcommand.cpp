@@ -20,26 +20,28 @@
 
 #include <utility>
 
+#include "../common/renderitems.hpp"
 #include "../context/applicationcontext.hpp"
 #include "../context/coordinatetransformer.hpp"
 #include "../context/selectioncontext.hpp"
 #include "../context/spatialcontext.hpp"
 #include "../data-structures/cachegrid.hpp"
 #include "../data-structures/quadtree.hpp"
+#include "../serializer/journal.hpp"
 
 InsertItemCommand::InsertItemCommand(QVector<std::shared_ptr<Item>> items) : ItemCommand{std::move(items)} {
 }
 
 void InsertItemCommand::execute(ApplicationContext *context) {
-    auto &transformer{context->spatialContext().coordinateTransformer()};
     auto &quadtree{context->spatialContext().quadtree()};
-    auto &cacheGrid{context->spatialContext().cacheGrid()};
 
     for (auto &item : m_items) {
-        QRect dirtyRegion{transformer.worldToGrid(item->boundingBox()).toRect()};
         quadtree.insertItem(item);
-        cacheGrid.markDirty(dirtyRegion);
     }
+
+    // new items always end up on top, so they can be painted over the cached
+    // cells without redrawing what lies beneath them
+    Common::renderNewItems(context, m_items);
 }
 
 void InsertItemCommand::undo(ApplicationContext *context) {
@@ -56,3 +58,20 @@ void InsertItemCommand::undo(ApplicationContext *context) {
         cacheGrid.markDirty(dirtyRegion);
     }
 }
+
+void InsertItemCommand::journal(Journal &journal, bool undone) const {
+    for (const auto &item : m_items) {
+        if (undone) {
+            journal.remove(*item);
+        } else {
+            journal.insert(*item);
+        }
+    }
+}
+
+// undoing only took the items themselves out of the z-order
+void InsertItemCommand::discard(ApplicationContext *context, bool undone) {
+    if (undone) {
+        release(context, m_items);
+    }
+}
@@ -21,9 +21,27 @@
 #include <QDebug>
 #include <utility>
 
+#include "../context/applicationcontext.hpp"
+#include "../context/spatialcontext.hpp"
+#include "../data-structures/quadtree.hpp"
+#include "../item/group.hpp"
+
 ItemCommand::ItemCommand(QVector<std::shared_ptr<Item>> items) : m_items{std::move(items)} {
 }
 
 ItemCommand::~ItemCommand() {
     qDebug() << "Object deleted: ItemCommand";
 }
+
+void ItemCommand::release(ApplicationContext *context,
+                          const QVector<std::shared_ptr<Item>> &items) {
+    auto &quadtree{context->spatialContext().quadtree()};
+
+    for (const auto &item : items) {
+        quadtree.deleteItem(item);
+
+        if (item->type() == Item::Group) {
+            release(context, std::static_pointer_cast<GroupItem>(item)->items());
+        }
+    }
+}
@@ -32,4 +32,8 @@ public:
 
 protected:
     QVector<std::shared_ptr<Item>> m_items;
+
+    // drops items that are out of the quadtree from the z-order for good,
+    // along with the children of groups that the z-order keeps below them
+    static void release(ApplicationContext *context, const QVector<std::shared_ptr<Item>> &items);
 };
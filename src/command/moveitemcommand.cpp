@@ -25,6 +25,7 @@
 #include "../context/spatialcontext.hpp"
 #include "../data-structures/cachegrid.hpp"
 #include "../item/item.hpp"
+#include "../serializer/journal.hpp"
 
 MoveItemCommand::MoveItemCommand(QVector<std::shared_ptr<Item>> items, QPointF delta)
     : ItemCommand{std::move(items)},
@@ -54,3 +55,9 @@ void MoveItemCommand::undo(ApplicationContext *context) {
         cacheGrid.markDirty(transformer.worldToGrid(item->boundingBox()).toRect());
     }
 }
+
+void MoveItemCommand::journal(Journal &journal, bool undone) const {
+    for (const auto &item : m_items) {
+        journal.move(*item, undone ? -m_delta : m_delta);
+    }
+}
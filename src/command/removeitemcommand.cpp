@@ -28,6 +28,7 @@
 #include "../data-structures/cachegrid.hpp"
 #include "../data-structures/quadtree.hpp"
 #include "../item/item.hpp"
+#include "../serializer/journal.hpp"
 
 RemoveItemCommand::RemoveItemCommand(QVector<std::shared_ptr<Item>> items) : ItemCommand{std::move(items)} {
 }
@@ -59,3 +60,22 @@ void RemoveItemCommand::undo(ApplicationContext *context) {
         cacheGrid.markDirty(dirtyRegion);
     }
 }
+
+// nothing can bring the items back once the command is gone
+void RemoveItemCommand::discard(ApplicationContext *context, bool undone) {
+    if (!undone) {
+        release(context, m_items);
+    }
+}
+
+// removed items keep their place in the z-order, so undoing puts them back
+// where they were
+void RemoveItemCommand::journal(Journal &journal, bool undone) const {
+    for (const auto &item : m_items) {
+        if (undone) {
+            journal.update(*item);
+        } else {
+            journal.remove(*item);
+        }
+    }
+}
@@ -27,4 +27,6 @@ public:
 
     void execute(ApplicationContext *context) override;
     void undo(ApplicationContext *context) override;
+    void journal(Journal &journal, bool undone) const override;
+    void discard(ApplicationContext *context, bool undone) override;
 };
@@ -25,6 +25,7 @@
 #include "../data-structures/cachegrid.hpp"
 #include "../data-structures/quadtree.hpp"
 #include "../item/group.hpp"
+#include "../serializer/journal.hpp"
 #include <memory>
 
 UngroupCommand::UngroupCommand(const QVector<std::shared_ptr<Item>>& items) : ItemCommand{items} {
@@ -79,3 +80,20 @@ void UngroupCommand::undo(ApplicationContext *context) {
 
     context->spatialContext().cacheGrid().markDirty(dirtyRegion.toRect());
 }
+
+void UngroupCommand::journal(Journal &journal, bool undone) const {
+    for (const auto &group : m_groups) {
+        if (undone) {
+            for (const auto &item : group->items()) {
+                journal.remove(*item);
+            }
+            journal.insert(*group);
+            continue;
+        }
+
+        journal.remove(*group);
+        for (const auto &item : group->items()) {
+            journal.update(*item);
+        }
+    }
+}
@@ -27,6 +27,7 @@
 #include "../data-structures/cachegrid.hpp"
 #include "../item/item.hpp"
 #include "../properties/property.hpp"
+#include "../serializer/journal.hpp"
 
 UpdatePropertyCommand::UpdatePropertyCommand(QVector<std::shared_ptr<Item>> items,
                                              Property newProperty)
@@ -37,10 +38,14 @@ UpdatePropertyCommand::UpdatePropertyCommand(QVector<std::shared_ptr<Item>> item
 void UpdatePropertyCommand::execute(ApplicationContext *context) {
     Property::Type type{m_newProperty.type()};
 
+    m_properties.clear();
+    m_properties.resize(m_items.size());
+
     QRectF dirtyRegion{};
-    for (auto &item : m_items) {
+    for (qsizetype i{0}; i < m_items.size(); i++) {
+        auto &item{m_items[i]};
         try {
-            m_properties[item] = item->property(type);
+            m_properties[i] = item->property(type);
             item->setProperty(type, m_newProperty);
             dirtyRegion |= item->boundingBox();
         } catch (const std::logic_error &e) {
@@ -57,9 +62,10 @@ void UpdatePropertyCommand::undo(ApplicationContext *context) {
     Property::Type type{m_newProperty.type()};
 
     QRectF dirtyRegion{};
-    for (auto &item : m_items) {
+    for (qsizetype i{0}; i < m_items.size(); i++) {
+        auto &item{m_items[i]};
         try {
-            item->setProperty(type, m_properties[item]);
+            item->setProperty(type, m_properties[i]);
             dirtyRegion |= item->boundingBox();
         } catch (const std::logic_error &e) {
             // Ignore if not found
@@ -70,3 +76,21 @@ void UpdatePropertyCommand::undo(ApplicationContext *context) {
         context->spatialContext().coordinateTransformer().worldToGrid(dirtyRegion).toRect()};
     context->spatialContext().cacheGrid().markDirty(gridDirtyRegion);
 };
+
+void UpdatePropertyCommand::journal(Journal &journal, bool undone) const {
+    Property::Type type{m_newProperty.type()};
+
+    for (const auto &item : m_items) {
+        // a group has no single value for the property when undone
+        if (item->type() == Item::Group) {
+            journal.update(*item);
+            continue;
+        }
+
+        try {
+            journal.setProperty(*item, item->property(type));
+        } catch (const std::logic_error &e) {
+            // Ignore if not found
+        }
+    }
+}
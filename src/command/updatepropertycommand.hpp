@@ -28,8 +28,10 @@ public:
 
     void execute(ApplicationContext *context) override;
     void undo(ApplicationContext *context) override;
+    void journal(Journal &journal, bool undone) const override;
 
 private:
     Property m_newProperty{};
-    std::unordered_map<std::shared_ptr<Item>, Property> m_properties{};
+    // old values, parallel to m_items
+    QVector<Property> m_properties{};
 };
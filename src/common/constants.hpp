@@ -58,6 +58,15 @@ inline constexpr std::array<QChar, 38> wordSeparators{
 
 inline constexpr int doubleClickInterval{300};  // milliseconds
 
+inline constexpr qint64 defaultCacheBudget{256};  // in megabytes, see "cacheBudget" in settings.json
+inline constexpr double journalCompactionRatio{0.5};  // journal size relative to its document that triggers a full save
+inline constexpr int defaultAutosaveInterval{60};  // in seconds, see "autosaveInterval" in settings.json, 0 disables it
+inline constexpr double renderBudget{0.5};  // fraction of a frame spent redrawing cache cells
+inline constexpr int loadBatchSize{1024};   // items handed to the GUI thread at once while loading
+inline constexpr int maxTraceEvents{1'000'000};  // events kept by a trace, later ones are dropped
+inline constexpr double lodTolerance{0.5};  // in screen pixels, error allowed when strokes are decimated for zoomed out views
+inline constexpr double defaultStrokeTolerance{0.5};  // in screen pixels, see "strokeTolerance" in settings.json, 0 keeps every point
+
 inline constexpr qreal tabStopDistance{4};
 
 inline constexpr std::string_view drawyFileExt{"drawy"};
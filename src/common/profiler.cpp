@@ -0,0 +1,210 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profiler.hpp"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+
+#include "constants.hpp"
+
+namespace {
+// weight of the latest frame in the moving average shown by the overlay
+constexpr double averageWeight{0.1};
+}  // namespace
+
+Profiler *Profiler::m_instance{nullptr};
+
+Profiler::Profiler() {
+    m_clock.start();
+}
+
+Profiler &Profiler::instance() {
+    if (!m_instance) {
+        m_instance = new Profiler();
+    }
+
+    return *m_instance;
+}
+
+bool Profiler::overlayVisible() const {
+    return m_overlayVisible;
+}
+
+void Profiler::setOverlayVisible(bool visible) {
+    m_overlayVisible = visible;
+    updateEnabled();
+}
+
+bool Profiler::tracing() const {
+    return m_tracing.load(std::memory_order_relaxed);
+}
+
+void Profiler::startTrace() {
+    QMutexLocker locker{&m_mutex};
+    m_events.clear();
+    m_frames.clear();
+    m_tracing = true;
+    updateEnabled();
+}
+
+void Profiler::stopTrace() {
+    m_tracing = false;
+    updateEnabled();
+}
+
+bool Profiler::saveTrace(const QString &filePath) const {
+    QVector<Event> events{};
+    QVector<std::pair<qint64, Frame>> frames{};
+    {
+        QMutexLocker locker{&m_mutex};
+        events = m_events;
+        frames = m_frames;
+    }
+
+    QSaveFile file{filePath};
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Failed to open trace file:" << file.errorString();
+        return false;
+    }
+
+    // timestamps are in microseconds, names are literals and need no escaping
+    QTextStream out{&file};
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first{true};
+    auto separator = [&]() -> const char * {
+        const char *result{first ? "" : ",\n"};
+        first = false;
+        return result;
+    };
+
+    for (const Event &event : events) {
+        out << separator() << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+            << event.thread << ",\"ts\":" << event.startNs / 1000.0
+            << ",\"dur\":" << event.durationNs / 1000.0 << "}";
+    }
+
+    for (const auto &[endNs, frame] : frames) {
+        for (int counter{0}; counter < CounterCount; counter++) {
+            out << separator() << "{\"name\":\"" << counterName(static_cast<Counter>(counter))
+                << "\",\"ph\":\"C\",\"pid\":1,\"ts\":" << endNs / 1000.0 << ",\"args\":{\"value\":"
+                << frame.counters[counter] << "}}";
+        }
+    }
+
+    out << "\n]}\n";
+    out.flush();
+
+    if (out.status() != QTextStream::Ok || !file.commit()) {
+        qWarning() << "Failed to write trace file:" << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void Profiler::record(const char *name, qint64 startNs, qint64 durationNs) {
+    QMutexLocker locker{&m_mutex};
+    m_currentFrame.scopes[name] += durationNs;
+
+    if (m_tracing && m_events.size() < Common::maxTraceEvents) {
+        m_events.push_back(Event{name,
+                                 startNs,
+                                 durationNs,
+                                 reinterpret_cast<quint64>(QThread::currentThreadId())});
+    }
+}
+
+qint64 Profiler::now() const {
+    return m_clock.nsecsElapsed();
+}
+
+void Profiler::endFrame(qint64 durationNs) {
+    if (!enabled())
+        return;
+
+    Frame frame{};
+    frame.durationNs = durationNs;
+    for (int counter{0}; counter < CounterCount; counter++) {
+        // gauges keep their value, the rest starts over every frame
+        frame.counters[counter] = counter == PixmapBytes
+                                      ? m_counters[counter].load(std::memory_order_relaxed)
+                                      : m_counters[counter].exchange(0, std::memory_order_relaxed);
+    }
+
+    QMutexLocker locker{&m_mutex};
+    frame.scopes.swap(m_currentFrame.scopes);
+
+    double frameMs{durationNs / 1e6};
+    m_averageFrameMs = m_lastFrame.durationNs == 0
+                           ? frameMs
+                           : m_averageFrameMs * (1 - averageWeight) + frameMs * averageWeight;
+
+    if (m_tracing && m_frames.size() < Common::maxTraceEvents) {
+        m_frames.push_back({now(), frame});
+    }
+
+    m_lastFrame = std::move(frame);
+}
+
+Profiler::Frame Profiler::lastFrame() const {
+    QMutexLocker locker{&m_mutex};
+    return m_lastFrame;
+}
+
+double Profiler::averageFrameMs() const {
+    QMutexLocker locker{&m_mutex};
+    return m_averageFrameMs;
+}
+
+QString Profiler::counterName(Counter counter) {
+    switch (counter) {
+        case DirtyCellsRendered:
+            return "Dirty cells rendered";
+        case ItemsDrawn:
+            return "Items drawn";
+        case QuadTreeNodesVisited:
+            return "Quadtree nodes visited";
+        case CacheHits:
+            return "Cache hits";
+        case CacheMisses:
+            return "Cache misses";
+        case CacheEvictions:
+            return "Cache evictions";
+        case PixmapBytes:
+            return "Pixmap bytes";
+        default:
+            return "";
+    }
+}
+
+void Profiler::updateEnabled() {
+    bool enabled{m_overlayVisible || tracing()};
+    if (enabled && !this->enabled()) {
+        // nothing counted while disabled belongs to the first frame
+        for (auto &counter : m_counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
@@ -0,0 +1,149 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <array>
+#include <atomic>
+
+/*
+ * Counters and scoped timers for the hot paths, shown by the performance
+ * overlay and recorded as a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * Everything is a no-op until the profiler is enabled, the disabled cost of
+ * a counter or timer is a relaxed atomic load. Counters can be bumped from
+ * any thread, a frame (see endFrame()) collects and resets them.
+ */
+class Profiler {
+public:
+    enum Counter {
+        DirtyCellsRendered,
+        ItemsDrawn,
+        QuadTreeNodesVisited,
+        CacheHits,
+        CacheMisses,
+        CacheEvictions,
+        PixmapBytes,  // a gauge, set rather than added to
+        CounterCount
+    };
+
+    struct Frame {
+        qint64 durationNs{};
+        std::array<qint64, CounterCount> counters{};
+        QMap<QString, qint64> scopes{};  // total time per timer name
+    };
+
+    static Profiler &instance();
+
+    bool enabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    // shows the overlay, counters and timers are collected while either the
+    // overlay is shown or a trace is recorded
+    bool overlayVisible() const;
+    void setOverlayVisible(bool visible);
+
+    bool tracing() const;
+    void startTrace();
+    void stopTrace();
+
+    // writes the events of the last trace to `filePath` as Chrome trace JSON
+    bool saveTrace(const QString &filePath) const;
+
+    void add(Counter counter, qint64 amount = 1) {
+        if (enabled())
+            m_counters[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void set(Counter counter, qint64 value) {
+        if (enabled())
+            m_counters[counter].store(value, std::memory_order_relaxed);
+    }
+
+    // called by the timers, `name` must be a string literal
+    void record(const char *name, qint64 startNs, qint64 durationNs);
+    qint64 now() const;
+
+    // closes the current frame: its counters are kept for the overlay (and
+    // the trace) and reset for the next one
+    void endFrame(qint64 durationNs);
+    Frame lastFrame() const;
+    double averageFrameMs() const;
+
+    static QString counterName(Counter counter);
+
+private:
+    Profiler();
+    Profiler(const Profiler &) = delete;
+
+    void updateEnabled();
+
+    struct Event {
+        const char *name;
+        qint64 startNs;
+        qint64 durationNs;
+        quint64 thread;
+    };
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<bool> m_tracing{false};
+    bool m_overlayVisible{false};
+
+    std::array<std::atomic<qint64>, CounterCount> m_counters{};
+    QElapsedTimer m_clock{};
+
+    mutable QMutex m_mutex{};
+    Frame m_currentFrame{};  // only the scopes, counters live in m_counters
+    Frame m_lastFrame{};
+    double m_averageFrameMs{};
+    QVector<Event> m_events{};
+    QVector<std::pair<qint64, Frame>> m_frames{};  // end time and frame
+
+    static Profiler *m_instance;
+};
+
+// Records the time until it goes out of scope under `name`, which must be a
+// string literal.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char *name)
+        : m_name{name},
+          m_startNs{Profiler::instance().enabled() ? Profiler::instance().now() : -1} {
+    }
+
+    ~ScopedTimer() {
+        if (m_startNs < 0)
+            return;
+
+        Profiler &profiler{Profiler::instance()};
+        profiler.record(m_name, m_startNs, profiler.now() - m_startNs);
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    const char *m_name;
+    qint64 m_startNs;
+};
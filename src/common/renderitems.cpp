@@ -18,8 +18,14 @@
 
 #include "renderitems.hpp"
 
+#include <QElapsedTimer>
+#include <QPainter>
 #include <QPointF>
+#include <QRegion>
 #include <QRectF>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
 #include <memory>
 
 #include "../canvas/canvas.hpp"
@@ -32,9 +38,54 @@
 #include "../data-structures/quadtree.hpp"
 #include "../item/item.hpp"
 #include "constants.hpp"
+#include "profiler.hpp"
+
+namespace {
+struct CellJob {
+    std::shared_ptr<CacheCell> cell;
+    QVector<std::shared_ptr<Item>> items;
+    QPointF topLeft;
+};
+
+void rasterize(CellJob &job, qreal zoomFactor) {
+    ScopedTimer timer{"rasterize cell"};
+    Profiler::instance().add(Profiler::ItemsDrawn, job.items.size());
+
+    QPainter painter{&job.cell->image()};
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+    painter.scale(zoomFactor, zoomFactor);
+
+    for (const auto &item : job.items) {
+        item->draw(painter, job.topLeft);
+    }
+}
+
+// Rasterizes the jobs on the render pool, the calling thread takes part too.
+// Returns once every job is done, so nothing may modify the items meanwhile.
+void rasterize(QVector<CellJob> &jobs, qreal zoomFactor, QThreadPool &pool) {
+    std::atomic<qsizetype> nextJob{0};
+    auto worker = [&]() {
+        for (qsizetype cur{nextJob++}; cur < jobs.size(); cur = nextJob++) {
+            rasterize(jobs[cur], zoomFactor);
+        }
+    };
+
+    int helpers{std::min(pool.maxThreadCount(), static_cast<int>(jobs.size()) - 1)};
+    for (int i{0}; i < helpers; i++) {
+        pool.start(worker);
+    }
+
+    worker();
+    pool.waitForDone();
+}
+}  // namespace
 
 // TODO: Refactor this
-void Common::renderCanvas(ApplicationContext *context) {
+bool Common::renderCanvas(ApplicationContext *context, int budget) {
+    ScopedTimer scopedTimer{"renderCanvas"};
+    QElapsedTimer timer{};
+    timer.start();
+
     CoordinateTransformer &transformer{context->spatialContext().coordinateTransformer()};
     Canvas &canvas{context->renderingContext().canvas()};
     QPointF offsetPos{context->spatialContext().offsetPos()};
@@ -44,50 +95,118 @@ void Common::renderCanvas(ApplicationContext *context) {
     QPointF gridOffset{transformer.worldToGrid(offsetPos)};
     QRectF gridViewport(gridOffset, transformer.viewToGrid(canvas.dimensions()));
 
+    CacheGrid &cacheGrid{context->spatialContext().cacheGrid()};
     QVector<std::shared_ptr<CacheCell>> visibleCells{
-        context->spatialContext().cacheGrid().queryCells(transformer.round(gridViewport))};
+        cacheGrid.queryCells(transformer.round(gridViewport))};
 
     QPainter &canvasPainter{context->renderingContext().canvasPainter()};
+    QThreadPool &renderPool{context->renderingContext().renderPool()};
+    qreal zoomFactor{context->renderingContext().zoomFactor()};
 
+    QVector<std::shared_ptr<CacheCell>> dirtyCells{};
     for (const auto& cell : visibleCells) {
-        // canvasPainter.save();
-        // QPen pen; pen.setColor(Qt::white); canvasPainter.setPen(pen);
-        // canvasPainter.drawRect(transformer.gridToView(cell->rect()));
-        // canvasPainter.restore();
+        if (cell->dirty())
+            dirtyCells.push_back(cell);
+    }
+
+    // cells near the center are the ones the user is looking at
+    QPointF center{gridViewport.center()};
+    std::sort(dirtyCells.begin(), dirtyCells.end(), [&](const auto &first, const auto &second) {
+        QPointF firstDistance{first->rect().toRectF().center() - center};
+        QPointF secondDistance{second->rect().toRectF().center() - center};
+        return QPointF::dotProduct(firstDistance, firstDistance) <
+               QPointF::dotProduct(secondDistance, secondDistance);
+    });
+
+    // cells are redrawn in batches that keep the whole pool busy, the budget
+    // is checked in between so at least one batch is drawn every frame
+    qsizetype batchSize{renderPool.maxThreadCount() + 1};
+    qsizetype nextCell{0};
+    while (nextCell < dirtyCells.size()) {
+        // the quadtree is not thread safe, so dirty cells are queried here and
+        // only the rasterization runs in parallel
+        QVector<CellJob> jobs{};
+        qsizetype batchEnd{std::min(nextCell + batchSize, dirtyCells.size())};
+        for (; nextCell < batchEnd; nextCell++) {
+            const auto &cell{dirtyCells[nextCell]};
+            Profiler::instance().add(Profiler::DirtyCellsRendered);
 
-        if (cell->dirty()) {
-            cell->image().fill(Qt::transparent);
             cell->setDirty(false);
+            cell->setRendered(true);
 
             QVector<std::shared_ptr<Item>> intersectingItems{
                 context->spatialContext().quadtree().queryItems(
                     transformer.gridToWorld(cell->rect()),
-                    [](const auto& a, auto b) { return true; })};
+                    [](const auto &item, const QRectF &rect) { return item->overlaps(rect); })};
 
-            if (intersectingItems.empty())
+            // empty cells keep no image at all
+            if (intersectingItems.empty()) {
+                cacheGrid.release(*cell);
                 continue;
+            }
 
-            qreal zoomFactor{context->renderingContext().zoomFactor()};
+            cacheGrid.allocate(*cell);
+            cell->image().fill(Qt::transparent);
 
             QPointF topLeftPoint{transformer.gridToWorld(cell->rect().topLeft().toPointF())};
+            jobs.push_back({cell, std::move(intersectingItems), topLeftPoint});
+        }
 
-            cell->painter().resetTransform();
-            cell->painter().scale(zoomFactor, zoomFactor);
+        if (!jobs.empty()) {
+            rasterize(jobs, zoomFactor, renderPool);
+        }
 
-            for (const auto& intersectingItem : intersectingItems) {
-                intersectingItem->draw(cell->painter(), topLeftPoint);
-            }
+        if (budget >= 0 && timer.elapsed() >= budget)
+            break;
+    }
+
+    // cells that were never drawn at this zoom level borrow the scaled
+    // contents of the previous level until they are redrawn
+    QRegion placeholderRegion{};
+    for (const auto& cell : visibleCells) {
+        if (!cell->rendered())
+            placeholderRegion += transformer.round(transformer.gridToView(cell->rect()));
+    }
+
+    if (!placeholderRegion.isEmpty() && cacheGrid.previousLevel() != cacheGrid.level()) {
+        int previousLevel{cacheGrid.previousLevel()};
+        qreal previousZoom{CacheGrid::zoomFactor(previousLevel)};
+
+        QRectF worldViewport{transformer.gridToWorld(gridViewport)};
+        QRectF previousViewport{worldViewport.topLeft() * previousZoom,
+                                worldViewport.size() * previousZoom};
+
+        canvasPainter.save();
+        canvasPainter.setClipRegion(placeholderRegion);
+
+        for (const auto& cell : cacheGrid.cachedCells(previousLevel, previousViewport.toAlignedRect())) {
+            if (!cell->rendered() || cell->empty())
+                continue;
+
+            QRectF cellRect{cell->rect().toRectF()};
+            QRectF worldRect{cellRect.topLeft() / previousZoom, cellRect.size() / previousZoom};
+            canvasPainter.drawImage(transformer.worldToView(worldRect), cell->image());
         }
 
-        canvasPainter.drawPixmap(transformer.round(transformer.gridToView(cell->rect())),
-                                 cell->image());
+        canvasPainter.restore();
     }
 
+    for (const auto& cell : visibleCells) {
+        // a cell that is still dirty shows its old contents until it is redrawn
+        if (!cell->rendered() || cell->empty())
+            continue;
+
+        canvasPainter.drawImage(transformer.round(transformer.gridToView(cell->rect())),
+                                cell->image());
+    }
+
+    bool complete{nextCell == dirtyCells.size()};
+
     QRectF selectionBox{};
     auto &selectedItems{context->selectionContext().selectedItems()};
 
     if (selectedItems.empty())
-        return;
+        return complete;
 
     // render a box around selected items
     canvasPainter.save();
@@ -105,4 +224,39 @@ void Common::renderCanvas(ApplicationContext *context) {
     canvasPainter.setPen(pen);
     canvasPainter.drawRect(selectionBox);
     canvasPainter.restore();
+
+    return complete;
+}
+
+void Common::renderNewItems(ApplicationContext *context,
+                            const QVector<std::shared_ptr<Item>> &items) {
+    ScopedTimer timer{"renderNewItems"};
+    CoordinateTransformer &transformer{context->spatialContext().coordinateTransformer()};
+    CacheGrid &cacheGrid{context->spatialContext().cacheGrid()};
+    qreal zoomFactor{context->renderingContext().zoomFactor()};
+
+    for (const auto& item : items) {
+        QRect gridRect{transformer.worldToGrid(item->boundingBox()).toAlignedRect()};
+
+        for (const auto& cell : cacheGrid.cachedCells(cacheGrid.level(), gridRect)) {
+            // dirty cells are redrawn from scratch anyway
+            if (cell->dirty() || !cell->rendered())
+                continue;
+
+            if (cell->empty()) {
+                cacheGrid.allocate(*cell);
+                cell->image().fill(Qt::transparent);
+            }
+
+            QPointF topLeftPoint{transformer.gridToWorld(cell->rect().topLeft().toPointF())};
+
+            QPainter painter{&cell->image()};
+            painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+            painter.scale(zoomFactor, zoomFactor);
+            item->draw(painter, topLeftPoint);
+            Profiler::instance().add(Profiler::ItemsDrawn);
+        }
+
+        cacheGrid.markOtherLevelsDirty(gridRect);
+    }
 }
@@ -18,8 +18,18 @@
 
 #pragma once
 
+#include <QVector>
+#include <memory>
 class ApplicationContext;
+class Item;
 
 namespace Common {
-void renderCanvas(ApplicationContext *context);
+// Redraws dirty cache cells, nearest to the center of the viewport first, and
+// composites them onto the canvas. Stops redrawing once `budget` milliseconds
+// have passed (-1 means no limit) and returns false if dirty cells are left.
+bool renderCanvas(ApplicationContext *context, int budget = -1);
+
+// Paints items that were just placed on top of every other item straight onto
+// the cached cells of the current zoom level, other levels are marked dirty.
+void renderNewItems(ApplicationContext *context, const QVector<std::shared_ptr<Item>> &items);
 };
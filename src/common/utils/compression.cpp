@@ -25,18 +25,82 @@
 
 #include "compression.hpp"
 
+#include <QDebug>
+#include <QThread>
+
+#include "settings.hpp"
+
 #include <io/CompressedInputStream.hpp>
 #include <io/CompressedOutputStream.hpp>
+#include <algorithm>
+#include <exception>
 #include <ios>
 #include <sstream>
+#include <stdexcept>
 
 namespace Common::Utils::Compression {
-QByteArray compressData(const QByteArray &data) {
+namespace {
+constexpr char kanziMagic[4]{'K', 'A', 'N', 'Z'};
+
+// kanzi throws if it was built without concurrency and more than one job is
+// asked for, in that case everything is compressed on the calling thread
+std::unique_ptr<kanzi::CompressedOutputStream> createOutputStream(std::ostream &stream,
+                                                                  const Profile &profile) {
+    try {
+        return std::make_unique<kanzi::CompressedOutputStream>(
+            stream, profile.jobs, profile.entropy, profile.transform);
+    } catch (const std::invalid_argument &e) {
+        if (profile.jobs == 1)
+            throw;
+
+        qWarning() << "Compressing with a single job:" << e.what();
+        return std::make_unique<kanzi::CompressedOutputStream>(
+            stream, 1, profile.entropy, profile.transform);
+    }
+}
+
+std::unique_ptr<kanzi::CompressedInputStream> createInputStream(std::istream &stream, int jobs) {
+    try {
+        return std::make_unique<kanzi::CompressedInputStream>(stream, jobs, "HUFFMAN", "LZX");
+    } catch (const std::invalid_argument &e) {
+        if (jobs == 1)
+            throw;
+
+        return std::make_unique<kanzi::CompressedInputStream>(stream, 1, "HUFFMAN", "LZX");
+    }
+}
+}  // namespace
+
+Profile Profile::fromPreset(Preset preset) {
+    QJsonObject settings{Settings::load()};
+
+    Profile profile{};
+    profile.jobs = std::max(settings.value("compressionJobs").toInt(QThread::idealThreadCount()), 1);
+
+    switch (preset) {
+        case Standard:
+            profile.entropy = settings.value("compressionEntropy").toString("HUFFMAN").toStdString();
+            profile.transform = settings.value("compressionTransform").toString("LZX").toStdString();
+            break;
+        case Fast:
+            profile.entropy = "NONE";
+            profile.transform = "LZ";
+            break;
+        case Dense:
+            profile.entropy = "TPAQ";
+            profile.transform = "BWT+SRT+ZRLT";
+            break;
+    }
+
+    return profile;
+}
+
+QByteArray compressData(const QByteArray &data, const Profile &profile) {
     std::ostringstream stream{std::ios::binary};
 
-    kanzi::CompressedOutputStream cStream{stream, 1, "HUFFMAN", "LZX"};
-    cStream.write(data.constData(), static_cast<std::streamsize>(data.size()));
-    cStream.close();
+    std::unique_ptr<kanzi::CompressedOutputStream> cStream{createOutputStream(stream, profile)};
+    cStream->write(data.constData(), static_cast<std::streamsize>(data.size()));
+    cStream->close();
 
     std::string result = stream.str();
     return QByteArray(result.data(), static_cast<int>(result.size()));
@@ -70,4 +134,194 @@ QByteArray decompressData(const QByteArray &data) {
     std::string result = out.str();
     return QByteArray(result.data(), static_cast<int>(result.size()));
 }
+
+bool isCompressed(const QByteArray &data) {
+    return data.startsWith(QByteArrayView{kanziMagic, sizeof(kanziMagic)});
+}
+
+DeviceStreamBuf::DeviceStreamBuf(QIODevice *device) : m_device{device} {
+}
+
+DeviceStreamBuf::~DeviceStreamBuf() {
+}
+
+DeviceStreamBuf::int_type DeviceStreamBuf::overflow(int_type ch) {
+    if (traits_type::eq_int_type(ch, traits_type::eof()))
+        return traits_type::not_eof(ch);
+
+    char c{traits_type::to_char_type(ch)};
+    return m_device->write(&c, 1) == 1 ? ch : traits_type::eof();
+}
+
+// kanzi writes whole blocks, so this passes them to the device unbuffered
+std::streamsize DeviceStreamBuf::xsputn(const char *data, std::streamsize count) {
+    qint64 written{m_device->write(data, count)};
+    return written < 0 ? 0 : static_cast<std::streamsize>(written);
+}
+
+DeviceStreamBuf::int_type DeviceStreamBuf::underflow() {
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    qint64 bytesRead{m_device->read(m_readBuffer, sizeof(m_readBuffer))};
+    if (bytesRead <= 0)
+        return traits_type::eof();
+
+    setg(m_readBuffer, m_readBuffer, m_readBuffer + bytesRead);
+    return traits_type::to_int_type(*gptr());
+}
+
+int DeviceStreamBuf::sync() {
+    return 0;
+}
+
+OutputDevice::OutputDevice(QIODevice *target, const Profile &profile)
+    : m_buffer{target},
+      m_profile{profile} {
+}
+
+OutputDevice::~OutputDevice() {
+    close();
+}
+
+bool OutputDevice::open(OpenMode mode) {
+    if (mode != QIODevice::WriteOnly)
+        return false;
+
+    m_stream = std::make_unique<std::ostream>(&m_buffer);
+    try {
+        m_compressed = createOutputStream(*m_stream, m_profile);
+    } catch (const std::exception &e) {
+        setErrorString(e.what());
+        m_stream.reset();
+        return false;
+    }
+    m_error = false;
+    return QIODevice::open(mode);
+}
+
+void OutputDevice::close() {
+    if (!isOpen())
+        return;
+
+    try {
+        m_compressed->close();
+        if (!m_stream->good()) {
+            setErrorString("Failed to write compressed data");
+            m_error = true;
+        }
+    } catch (const std::exception &e) {
+        setErrorString(e.what());
+        m_error = true;
+    }
+
+    m_compressed.reset();
+    m_stream.reset();
+    QIODevice::close();
+}
+
+bool OutputDevice::isSequential() const {
+    return true;
+}
+
+bool OutputDevice::hasError() const {
+    return m_error;
+}
+
+qint64 OutputDevice::readData(char *data, qint64 maxSize) {
+    return -1;
+}
+
+qint64 OutputDevice::writeData(const char *data, qint64 maxSize) {
+    try {
+        m_compressed->write(data, static_cast<std::streamsize>(maxSize));
+    } catch (const std::exception &e) {
+        setErrorString(e.what());
+        m_error = true;
+        return -1;
+    }
+
+    if (!m_stream->good()) {
+        setErrorString("Failed to write compressed data");
+        m_error = true;
+        return -1;
+    }
+
+    return maxSize;
+}
+
+InputDevice::InputDevice(QIODevice *source, int jobs) : m_buffer{source}, m_jobs{jobs} {
+}
+
+InputDevice::~InputDevice() {
+    close();
+}
+
+bool InputDevice::open(OpenMode mode) {
+    if (mode != QIODevice::ReadOnly)
+        return false;
+
+    m_stream = std::make_unique<std::istream>(&m_buffer);
+    try {
+        m_compressed = createInputStream(*m_stream, m_jobs);
+    } catch (const std::exception &e) {
+        setErrorString(e.what());
+        m_stream.reset();
+        return false;
+    }
+    m_finished = false;
+    m_error = false;
+    return QIODevice::open(mode);
+}
+
+void InputDevice::close() {
+    if (!isOpen())
+        return;
+
+    try {
+        m_compressed->close();
+    } catch (const std::exception &e) {
+        setErrorString(e.what());
+        m_error = true;
+    }
+
+    m_compressed.reset();
+    m_stream.reset();
+    QIODevice::close();
+}
+
+bool InputDevice::isSequential() const {
+    return true;
+}
+
+bool InputDevice::hasError() const {
+    return m_error;
+}
+
+qint64 InputDevice::readData(char *data, qint64 maxSize) {
+    if (m_finished)
+        return -1;
+
+    try {
+        m_compressed->read(data, static_cast<std::streamsize>(maxSize));
+    } catch (const std::exception &e) {
+        setErrorString(e.what());
+        m_error = true;
+        m_finished = true;
+        return -1;
+    }
+
+    std::streamsize n{m_compressed->gcount()};
+    if (m_compressed->eof())
+        m_finished = true;
+
+    if (n <= 0 && m_finished)
+        return -1;
+
+    return static_cast<qint64>(n);
+}
+
+qint64 InputDevice::writeData(const char *data, qint64 maxSize) {
+    return -1;
+}
 }  // namespace Common::Utils::Compression
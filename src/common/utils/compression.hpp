@@ -22,16 +22,132 @@
 #pragma once
 
 #include <QByteArray>
+#include <QIODevice>
 #include <QString>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+namespace kanzi {
+class CompressedInputStream;
+class CompressedOutputStream;
+}  // namespace kanzi
 
 namespace Common::Utils::Compression {
 /**
- * @brief Compresses data with Huffman coding and LZX.
+ * @brief The kanzi codecs to compress with and how many blocks to compress
+ * in parallel. Kanzi records the codecs in its own stream header, so data
+ * compressed with any profile is decompressed the same way.
  */
-QByteArray compressData(const QByteArray &data);
+struct Profile {
+    enum Preset { Standard, Fast, Dense };
+
+    std::string entropy{"HUFFMAN"};
+    std::string transform{"LZX"};
+    int jobs{1};
+
+    /**
+     * @brief Standard reads "compressionEntropy", "compressionTransform" and
+     * "compressionJobs" from settings.json, Fast skips entropy coding (used by
+     * autosaves) and Dense trades speed for size (used by archive exports).
+     */
+    static Profile fromPreset(Preset preset);
+};
+
+/**
+ * @brief Compresses data, by default with Huffman coding and LZX.
+ */
+QByteArray compressData(const QByteArray &data, const Profile &profile = Profile{});
 
 /**
  * @brief Performs the inverse operation of compressData().
  */
 QByteArray decompressData(const QByteArray &data);
+
+/**
+ * @brief Whether the data starts like a kanzi stream.
+ */
+bool isCompressed(const QByteArray &data);
+
+/**
+ * @brief std::streambuf over a QIODevice, lets kanzi streams read from and
+ * write to Qt devices without staging everything in a std::string.
+ */
+class DeviceStreamBuf : public std::streambuf {
+public:
+    explicit DeviceStreamBuf(QIODevice *device);
+    ~DeviceStreamBuf() override;
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char *data, std::streamsize count) override;
+    int_type underflow() override;
+    int sync() override;
+
+private:
+    QIODevice *m_device{};
+    char m_readBuffer[4096]{};
+};
+
+/**
+ * @brief Write-only device compressing everything written to it into the
+ * target device. Kanzi buffers one block per job, close() flushes the last
+ * ones.
+ */
+class OutputDevice : public QIODevice {
+public:
+    explicit OutputDevice(QIODevice *target, const Profile &profile = Profile{});
+    ~OutputDevice() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+
+    /**
+     * @brief Whether kanzi or the target device failed, see errorString().
+     */
+    bool hasError() const;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    DeviceStreamBuf m_buffer;
+    Profile m_profile{};
+    std::unique_ptr<std::ostream> m_stream{};
+    std::unique_ptr<kanzi::CompressedOutputStream> m_compressed{};
+    bool m_error{false};
+};
+
+/**
+ * @brief Read-only device decompressing the data of the source device on the
+ * fly, the inverse of OutputDevice.
+ */
+class InputDevice : public QIODevice {
+public:
+    explicit InputDevice(QIODevice *source, int jobs = 1);
+    ~InputDevice() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+
+    /**
+     * @brief Whether kanzi or the source device failed, see errorString().
+     */
+    bool hasError() const;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    DeviceStreamBuf m_buffer;
+    int m_jobs{1};
+    std::unique_ptr<std::istream> m_stream{};
+    std::unique_ptr<kanzi::CompressedInputStream> m_compressed{};
+    bool m_finished{false};
+    bool m_error{false};
+};
 }  // namespace Common::Utils::Compression
@@ -20,13 +20,17 @@
 
 #include <QLineF>
 #include <QRectF>
+#include <algorithm>
+#include <utility>
 
 namespace Common::Utils::Math {
 inline int orientation(QPointF a, QPointF b, QPointF c) {
     QPointF ab{b.x() - a.x(), b.y() - a.y()};
     QPointF ac{c.x() - a.x(), c.y() - a.y()};
 
-    int orient{static_cast<int>(ab.x() * ac.y() - ac.x() * ab.y())};
+    // compared as a double, truncating to an int made nearly collinear
+    // points collinear
+    double orient{ab.x() * ac.y() - ac.x() * ab.y()};
     return (orient == 0 ? 0 : (orient < 0 ? -1 : 1));
 }
 
@@ -54,4 +58,39 @@ inline bool intersects(const QRectF &rect, const QLineF &line) {
 inline bool intersects(const QRectF &rect, const QPointF &point) {
     return rect.contains(point);
 }
+
+// position of `point` along a hilbert curve covering `bounds` at 2^16 x 2^16
+// resolution, points close on the curve are close on the canvas
+inline quint32 hilbertIndex(const QRectF &bounds, const QPointF &point) {
+    constexpr quint32 order{1u << 16};
+
+    auto normalize = [&](double value, double min, double size) -> quint32 {
+        if (size <= 0) {
+            return 0;
+        }
+        double scaled{(value - min) / size * (order - 1)};
+        return static_cast<quint32>(std::clamp(scaled, 0.0, static_cast<double>(order - 1)));
+    };
+
+    quint32 x{normalize(point.x(), bounds.x(), bounds.width())};
+    quint32 y{normalize(point.y(), bounds.y(), bounds.height())};
+
+    quint32 index{0};
+    for (quint32 s{order / 2}; s > 0; s /= 2) {
+        quint32 rx{(x & s) > 0 ? 1u : 0u};
+        quint32 ry{(y & s) > 0 ? 1u : 0u};
+        index += s * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+
+    return index;
+}
 };  // namespace Common::Utils::Math
@@ -0,0 +1,345 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "segments.hpp"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DRAWY_SEGMENTS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(DRAWY_SEGMENTS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define DRAWY_SEGMENTS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace {
+using Kernel = Common::Utils::Segments::Kernel;
+
+struct Rect {
+    double left, top, right, bottom;
+};
+
+struct Line {
+    double x0, y0, x1, y1;
+};
+
+// A segment touches a rectangle if their bounding boxes overlap and the
+// corners of the rectangle are not all on the same side of the segment.
+inline bool touches(double x0, double y0, double x1, double y1, const Rect &rect) {
+    if (std::min(x0, x1) > rect.right || std::max(x0, x1) < rect.left ||
+        std::min(y0, y1) > rect.bottom || std::max(y0, y1) < rect.top)
+        return false;
+
+    double dx{x1 - x0}, dy{y1 - y0};
+    auto side = [&](double x, double y) { return dx * (y - y0) - dy * (x - x0); };
+
+    double s1{side(rect.left, rect.top)}, s2{side(rect.right, rect.top)};
+    double s3{side(rect.right, rect.bottom)}, s4{side(rect.left, rect.bottom)};
+
+    bool above{s1 > 0 && s2 > 0 && s3 > 0 && s4 > 0};
+    bool below{s1 < 0 && s2 < 0 && s3 < 0 && s4 < 0};
+    return !above && !below;
+}
+
+inline int sign(double value) {
+    return value > 0 ? 1 : (value < 0 ? -1 : 0);
+}
+
+// the same test as Math::intersects(QLineF, QLineF)
+inline bool crosses(double x0, double y0, double x1, double y1, const Line &line) {
+    double dx{x1 - x0}, dy{y1 - y0};
+    double lx{line.x1 - line.x0}, ly{line.y1 - line.y0};
+
+    int o1{sign(dx * (line.y0 - y0) - dy * (line.x0 - x0))};
+    int o2{sign(dx * (line.y1 - y0) - dy * (line.x1 - x0))};
+    int o3{sign(lx * (y0 - line.y0) - ly * (x0 - line.x0))};
+    int o4{sign(lx * (y1 - line.y0) - ly * (x1 - line.x0))};
+    return o1 != o2 && o3 != o4;
+}
+
+template <typename Shape, typename Test>
+bool scalar(const QPointF *points, qsizetype first, qsizetype count, const Shape &shape, Test test) {
+    for (qsizetype index{first}; index + 1 < count; index++) {
+        if (test(points[index].x(), points[index].y(), points[index + 1].x(),
+                 points[index + 1].y(), shape))
+            return true;
+    }
+
+    return false;
+}
+
+#ifdef DRAWY_SEGMENTS_SSE2
+// two segments at a time, QPointF is two packed doubles
+bool touchesSSE2(const QPointF *points, qsizetype count, const Rect &rect) {
+    const double *data{reinterpret_cast<const double *>(points)};
+    __m128d left{_mm_set1_pd(rect.left)}, top{_mm_set1_pd(rect.top)};
+    __m128d right{_mm_set1_pd(rect.right)}, bottom{_mm_set1_pd(rect.bottom)};
+    __m128d zero{_mm_setzero_pd()};
+
+    qsizetype index{0};
+    for (; index + 2 < count; index += 2) {
+        __m128d p0{_mm_loadu_pd(data + 2 * index)};
+        __m128d p1{_mm_loadu_pd(data + 2 * index + 2)};
+        __m128d p2{_mm_loadu_pd(data + 2 * index + 4)};
+
+        __m128d x0{_mm_unpacklo_pd(p0, p1)}, y0{_mm_unpackhi_pd(p0, p1)};
+        __m128d x1{_mm_unpacklo_pd(p1, p2)}, y1{_mm_unpackhi_pd(p1, p2)};
+
+        __m128d overlap{_mm_and_pd(
+            _mm_and_pd(_mm_cmple_pd(_mm_min_pd(x0, x1), right), _mm_cmpge_pd(_mm_max_pd(x0, x1), left)),
+            _mm_and_pd(_mm_cmple_pd(_mm_min_pd(y0, y1), bottom), _mm_cmpge_pd(_mm_max_pd(y0, y1), top)))};
+        if (_mm_movemask_pd(overlap) == 0)
+            continue;
+
+        __m128d dx{_mm_sub_pd(x1, x0)}, dy{_mm_sub_pd(y1, y0)};
+        auto side = [&](__m128d x, __m128d y) {
+            return _mm_sub_pd(_mm_mul_pd(dx, _mm_sub_pd(y, y0)), _mm_mul_pd(dy, _mm_sub_pd(x, x0)));
+        };
+
+        __m128d s1{side(left, top)}, s2{side(right, top)};
+        __m128d s3{side(right, bottom)}, s4{side(left, bottom)};
+
+        __m128d above{_mm_and_pd(_mm_and_pd(_mm_cmpgt_pd(s1, zero), _mm_cmpgt_pd(s2, zero)),
+                                 _mm_and_pd(_mm_cmpgt_pd(s3, zero), _mm_cmpgt_pd(s4, zero)))};
+        __m128d below{_mm_and_pd(_mm_and_pd(_mm_cmplt_pd(s1, zero), _mm_cmplt_pd(s2, zero)),
+                                 _mm_and_pd(_mm_cmplt_pd(s3, zero), _mm_cmplt_pd(s4, zero)))};
+
+        if (_mm_movemask_pd(_mm_andnot_pd(_mm_or_pd(above, below), overlap)) != 0)
+            return true;
+    }
+
+    return scalar(points, index, count, rect, touches);
+}
+
+// per lane whether the signs of `a` and `b` differ, like sign(a) != sign(b)
+inline __m128d signsDiffer(__m128d a, __m128d b) {
+    __m128d zero{_mm_setzero_pd()};
+    return _mm_or_pd(_mm_xor_pd(_mm_cmpgt_pd(a, zero), _mm_cmpgt_pd(b, zero)),
+                     _mm_xor_pd(_mm_cmplt_pd(a, zero), _mm_cmplt_pd(b, zero)));
+}
+
+bool crossesSSE2(const QPointF *points, qsizetype count, const Line &line) {
+    const double *data{reinterpret_cast<const double *>(points)};
+    __m128d lx0{_mm_set1_pd(line.x0)}, ly0{_mm_set1_pd(line.y0)};
+    __m128d lx1{_mm_set1_pd(line.x1)}, ly1{_mm_set1_pd(line.y1)};
+    __m128d ldx{_mm_set1_pd(line.x1 - line.x0)}, ldy{_mm_set1_pd(line.y1 - line.y0)};
+
+    qsizetype index{0};
+    for (; index + 2 < count; index += 2) {
+        __m128d p0{_mm_loadu_pd(data + 2 * index)};
+        __m128d p1{_mm_loadu_pd(data + 2 * index + 2)};
+        __m128d p2{_mm_loadu_pd(data + 2 * index + 4)};
+
+        __m128d x0{_mm_unpacklo_pd(p0, p1)}, y0{_mm_unpackhi_pd(p0, p1)};
+        __m128d x1{_mm_unpacklo_pd(p1, p2)}, y1{_mm_unpackhi_pd(p1, p2)};
+        __m128d dx{_mm_sub_pd(x1, x0)}, dy{_mm_sub_pd(y1, y0)};
+
+        __m128d o1{_mm_sub_pd(_mm_mul_pd(dx, _mm_sub_pd(ly0, y0)), _mm_mul_pd(dy, _mm_sub_pd(lx0, x0)))};
+        __m128d o2{_mm_sub_pd(_mm_mul_pd(dx, _mm_sub_pd(ly1, y0)), _mm_mul_pd(dy, _mm_sub_pd(lx1, x0)))};
+        __m128d o3{_mm_sub_pd(_mm_mul_pd(ldx, _mm_sub_pd(y0, ly0)), _mm_mul_pd(ldy, _mm_sub_pd(x0, lx0)))};
+        __m128d o4{_mm_sub_pd(_mm_mul_pd(ldx, _mm_sub_pd(y1, ly0)), _mm_mul_pd(ldy, _mm_sub_pd(x1, lx0)))};
+
+        if (_mm_movemask_pd(_mm_and_pd(signsDiffer(o1, o2), signsDiffer(o3, o4))) != 0)
+            return true;
+    }
+
+    return scalar(points, index, count, line, crosses);
+}
+#endif
+
+#ifdef DRAWY_SEGMENTS_AVX2
+// lambdas do not inherit the target attribute, hence these helpers
+__attribute__((target("avx2"))) inline __m256d cross(__m256d dx, __m256d dy, __m256d x, __m256d y) {
+    return _mm256_sub_pd(_mm256_mul_pd(dx, y), _mm256_mul_pd(dy, x));
+}
+
+__attribute__((target("avx2"))) inline __m256d signsDiffer(__m256d a, __m256d b) {
+    __m256d zero{_mm256_setzero_pd()};
+    return _mm256_or_pd(
+        _mm256_xor_pd(_mm256_cmp_pd(a, zero, _CMP_GT_OQ), _mm256_cmp_pd(b, zero, _CMP_GT_OQ)),
+        _mm256_xor_pd(_mm256_cmp_pd(a, zero, _CMP_LT_OQ), _mm256_cmp_pd(b, zero, _CMP_LT_OQ)));
+}
+
+// Four segments at a time. Unpacking works within 128 bit lanes, so the
+// segments end up in the order i, i + 2, i + 1, i + 3, which does not matter
+// as long as start and end points are shuffled the same way.
+__attribute__((target("avx2"))) bool touchesAVX2(const QPointF *points,
+                                                 qsizetype count,
+                                                 const Rect &rect) {
+    const double *data{reinterpret_cast<const double *>(points)};
+    __m256d left{_mm256_set1_pd(rect.left)}, top{_mm256_set1_pd(rect.top)};
+    __m256d right{_mm256_set1_pd(rect.right)}, bottom{_mm256_set1_pd(rect.bottom)};
+    __m256d zero{_mm256_setzero_pd()};
+
+    qsizetype index{0};
+    for (; index + 4 < count; index += 4) {
+        __m256d a{_mm256_loadu_pd(data + 2 * index)};      // points i, i + 1
+        __m256d b{_mm256_loadu_pd(data + 2 * index + 4)};  // points i + 2, i + 3
+        __m256d c{_mm256_loadu_pd(data + 2 * index + 2)};  // points i + 1, i + 2
+        __m256d d{_mm256_loadu_pd(data + 2 * index + 6)};  // points i + 3, i + 4
+
+        __m256d x0{_mm256_unpacklo_pd(a, b)}, y0{_mm256_unpackhi_pd(a, b)};
+        __m256d x1{_mm256_unpacklo_pd(c, d)}, y1{_mm256_unpackhi_pd(c, d)};
+
+        __m256d overlap{_mm256_and_pd(
+            _mm256_and_pd(_mm256_cmp_pd(_mm256_min_pd(x0, x1), right, _CMP_LE_OQ),
+                          _mm256_cmp_pd(_mm256_max_pd(x0, x1), left, _CMP_GE_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(_mm256_min_pd(y0, y1), bottom, _CMP_LE_OQ),
+                          _mm256_cmp_pd(_mm256_max_pd(y0, y1), top, _CMP_GE_OQ)))};
+        if (_mm256_movemask_pd(overlap) == 0)
+            continue;
+
+        __m256d dx{_mm256_sub_pd(x1, x0)}, dy{_mm256_sub_pd(y1, y0)};
+        __m256d dl{_mm256_sub_pd(left, x0)}, dr{_mm256_sub_pd(right, x0)};
+        __m256d dt{_mm256_sub_pd(top, y0)}, db{_mm256_sub_pd(bottom, y0)};
+
+        __m256d s1{cross(dx, dy, dl, dt)}, s2{cross(dx, dy, dr, dt)};
+        __m256d s3{cross(dx, dy, dr, db)}, s4{cross(dx, dy, dl, db)};
+
+        __m256d above{_mm256_and_pd(
+            _mm256_and_pd(_mm256_cmp_pd(s1, zero, _CMP_GT_OQ), _mm256_cmp_pd(s2, zero, _CMP_GT_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(s3, zero, _CMP_GT_OQ), _mm256_cmp_pd(s4, zero, _CMP_GT_OQ)))};
+        __m256d below{_mm256_and_pd(
+            _mm256_and_pd(_mm256_cmp_pd(s1, zero, _CMP_LT_OQ), _mm256_cmp_pd(s2, zero, _CMP_LT_OQ)),
+            _mm256_and_pd(_mm256_cmp_pd(s3, zero, _CMP_LT_OQ), _mm256_cmp_pd(s4, zero, _CMP_LT_OQ)))};
+
+        if (_mm256_movemask_pd(_mm256_andnot_pd(_mm256_or_pd(above, below), overlap)) != 0)
+            return true;
+    }
+
+    return scalar(points, index, count, rect, touches);
+}
+
+__attribute__((target("avx2"))) bool crossesAVX2(const QPointF *points,
+                                                 qsizetype count,
+                                                 const Line &line) {
+    const double *data{reinterpret_cast<const double *>(points)};
+    __m256d lx0{_mm256_set1_pd(line.x0)}, ly0{_mm256_set1_pd(line.y0)};
+    __m256d lx1{_mm256_set1_pd(line.x1)}, ly1{_mm256_set1_pd(line.y1)};
+    __m256d ldx{_mm256_set1_pd(line.x1 - line.x0)}, ldy{_mm256_set1_pd(line.y1 - line.y0)};
+
+    qsizetype index{0};
+    for (; index + 4 < count; index += 4) {
+        __m256d a{_mm256_loadu_pd(data + 2 * index)};
+        __m256d b{_mm256_loadu_pd(data + 2 * index + 4)};
+        __m256d c{_mm256_loadu_pd(data + 2 * index + 2)};
+        __m256d d{_mm256_loadu_pd(data + 2 * index + 6)};
+
+        __m256d x0{_mm256_unpacklo_pd(a, b)}, y0{_mm256_unpackhi_pd(a, b)};
+        __m256d x1{_mm256_unpacklo_pd(c, d)}, y1{_mm256_unpackhi_pd(c, d)};
+        __m256d dx{_mm256_sub_pd(x1, x0)}, dy{_mm256_sub_pd(y1, y0)};
+
+        __m256d o1{cross(dx, dy, _mm256_sub_pd(lx0, x0), _mm256_sub_pd(ly0, y0))};
+        __m256d o2{cross(dx, dy, _mm256_sub_pd(lx1, x0), _mm256_sub_pd(ly1, y0))};
+        __m256d o3{cross(ldx, ldy, _mm256_sub_pd(x0, lx0), _mm256_sub_pd(y0, ly0))};
+        __m256d o4{cross(ldx, ldy, _mm256_sub_pd(x1, lx0), _mm256_sub_pd(y1, ly0))};
+
+        if (_mm256_movemask_pd(_mm256_and_pd(signsDiffer(o1, o2), signsDiffer(o3, o4))) != 0)
+            return true;
+    }
+
+    return scalar(points, index, count, line, crosses);
+}
+#endif
+}  // namespace
+
+namespace Common::Utils::Segments {
+Kernel bestKernel() {
+    static const Kernel best{[]() {
+        if (supported(Kernel::AVX2))
+            return Kernel::AVX2;
+        if (supported(Kernel::SSE2))
+            return Kernel::SSE2;
+        return Kernel::Scalar;
+    }()};
+
+    return best;
+}
+
+bool supported(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar:
+            return true;
+        case Kernel::SSE2:
+#ifdef DRAWY_SEGMENTS_SSE2
+            return true;
+#else
+            return false;
+#endif
+        case Kernel::AVX2:
+#ifdef DRAWY_SEGMENTS_AVX2
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+
+    return false;
+}
+
+const char *kernelName(Kernel kernel) {
+    switch (kernel) {
+        case Kernel::Scalar:
+            return "scalar";
+        case Kernel::SSE2:
+            return "sse2";
+        case Kernel::AVX2:
+            return "avx2";
+    }
+
+    return "";
+}
+
+bool intersects(const QPointF *points, qsizetype count, const QRectF &rect, Kernel kernel) {
+    QRectF box{rect.normalized()};
+    Rect normalized{box.left(), box.top(), box.right(), box.bottom()};
+
+    switch (kernel) {
+#ifdef DRAWY_SEGMENTS_AVX2
+        case Kernel::AVX2:
+            return touchesAVX2(points, count, normalized);
+#endif
+#ifdef DRAWY_SEGMENTS_SSE2
+        case Kernel::SSE2:
+            return touchesSSE2(points, count, normalized);
+#endif
+        default:
+            return scalar(points, 0, count, normalized, touches);
+    }
+}
+
+bool intersects(const QPointF *points, qsizetype count, const QLineF &line, Kernel kernel) {
+    Line segment{line.x1(), line.y1(), line.x2(), line.y2()};
+
+    switch (kernel) {
+#ifdef DRAWY_SEGMENTS_AVX2
+        case Kernel::AVX2:
+            return crossesAVX2(points, count, segment);
+#endif
+#ifdef DRAWY_SEGMENTS_SSE2
+        case Kernel::SSE2:
+            return crossesSSE2(points, count, segment);
+#endif
+        default:
+            return scalar(points, 0, count, segment, crosses);
+    }
+}
+}  // namespace Common::Utils::Segments
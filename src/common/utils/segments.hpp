@@ -0,0 +1,50 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QLineF>
+#include <QPointF>
+#include <QRectF>
+
+/*
+ * Batch intersection tests for the segments of a polyline, the segments are
+ * (points[i], points[i + 1]). The tests run several segments at once with
+ * SSE2 or AVX2 when the CPU has them, the kernel is picked at runtime and a
+ * scalar version is always available.
+ */
+namespace Common::Utils::Segments {
+enum class Kernel { Scalar, SSE2, AVX2 };
+
+// the fastest kernel the CPU supports
+Kernel bestKernel();
+bool supported(Kernel kernel);
+const char *kernelName(Kernel kernel);
+
+// Whether any segment touches `rect`, crossing it or lying inside of it.
+bool intersects(const QPointF *points,
+                qsizetype count,
+                const QRectF &rect,
+                Kernel kernel = bestKernel());
+
+// Whether any segment crosses `line`, with the rules of Math::intersects().
+bool intersects(const QPointF *points,
+                qsizetype count,
+                const QLineF &line,
+                Kernel kernel = bestKernel());
+}  // namespace Common::Utils::Segments
@@ -0,0 +1,67 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "settings.hpp"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QStandardPaths>
+
+namespace Common::Utils::Settings {
+QString filePath() {
+    return QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) +
+           "/drawy/settings.json";
+}
+
+QJsonObject load() {
+    QFile settingsFile{filePath()};
+    if (!settingsFile.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+
+    QJsonDocument settingsDocument{QJsonDocument::fromJson(settingsFile.readAll())};
+    if (!settingsDocument.isObject()) {
+        return {};
+    }
+
+    return settingsDocument.object();
+}
+
+bool save(const QJsonObject &settings) {
+    QString path{filePath()};
+    QDir{}.mkpath(QFileInfo{path}.absolutePath());
+
+    QFile settingsFile{path};
+    if (!settingsFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write settings:" << settingsFile.errorString();
+        return false;
+    }
+
+    settingsFile.write(QJsonDocument{settings}.toJson());
+    return true;
+}
+
+bool setValue(const QString &key, const QJsonValue &value) {
+    QJsonObject settings{load()};
+    settings.insert(key, value);
+    return save(settings);
+}
+}  // namespace Common::Utils::Settings
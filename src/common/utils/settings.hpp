@@ -0,0 +1,45 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+
+namespace Common::Utils::Settings {
+/**
+ * @brief Path of the settings file, ~/.config/drawy/settings.json on Linux.
+ */
+QString filePath();
+
+/**
+ * @brief Reads the settings file, returns an empty object if it is missing or invalid.
+ */
+QJsonObject load();
+
+/**
+ * @brief Replaces the settings file with `settings`, creating its directory if needed.
+ */
+bool save(const QJsonObject &settings);
+
+/**
+ * @brief Sets one key and keeps the others, e.g. "lastOpenedFile".
+ */
+bool setValue(const QString &key, const QJsonValue &value);
+}  // namespace Common::Utils::Settings
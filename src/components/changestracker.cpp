@@ -18,9 +18,18 @@
 
 #include "changestracker.hpp"
 
+#include <QFile>
+#include <chrono>
+
+#include "../command/command.hpp"
 #include "../command/commandhistory.hpp"
+#include "../common/constants.hpp"
+#include "../common/utils/settings.hpp"
 #include "../context/applicationcontext.hpp"
+#include "../context/renderingcontext.hpp"
 #include "../context/spatialcontext.hpp"
+#include "../serializer/loadjob.hpp"
+#include "../serializer/serializer.hpp"
 
 ChangesTracker::ChangesTracker(ApplicationContext *context)
     : QObject(context),
@@ -31,9 +40,21 @@ ChangesTracker::ChangesTracker(ApplicationContext *context)
     
     connect(&commandHistory, &CommandHistory::commandExecuted, this, &ChangesTracker::m_onCommandExecuted);
     connect(&commandHistory, &CommandHistory::commandUndone, this, &ChangesTracker::m_onCommandUndone);
+
+    // a single thread keeps autosaves of the same file in order
+    m_savePool.setMaxThreadCount(1);
+
+    int autosaveInterval{Common::Utils::Settings::load()
+                             .value("autosaveInterval")
+                             .toInt(Common::defaultAutosaveInterval)};
+    if (autosaveInterval > 0) {
+        connect(&m_autosaveTimer, &QTimer::timeout, this, &ChangesTracker::m_autosave);
+        m_autosaveTimer.start(std::chrono::seconds{autosaveInterval});
+    }
 }
 
 ChangesTracker::~ChangesTracker() {
+    m_savePool.waitForDone();
     qDebug() << "Object deleted: ChangesTracker";
 }
 
@@ -49,18 +70,106 @@ void ChangesTracker::markSaved() {
 }
 
 void ChangesTracker::markChanged() {
+    m_generation++;
+
     if (!m_hasUnsavedChanges) {
         m_hasUnsavedChanges = true;
         emit changesStatusChanged(true);
     }
 }
 
-void ChangesTracker::m_onCommandExecuted() {
+void ChangesTracker::m_onCommandExecuted(const std::shared_ptr<Command> &command) {
+    command->journal(m_journal, false);
     markChanged();
 }
 
-void ChangesTracker::m_onCommandUndone() {
+void ChangesTracker::m_onCommandUndone(const std::shared_ptr<Command> &command) {
     // Note: This is a simplified implementation. A full implementation would
     // track the command history depth to determine if we're at a saved point.
+    command->journal(m_journal, true);
     markChanged();
-}
\ No newline at end of file
+}
+
+Journal &ChangesTracker::journal() {
+    return m_journal;
+}
+
+void ChangesTracker::waitForAutosave() {
+    m_savePool.waitForDone();
+
+    // the rebase is queued behind the event that is handled right now, a
+    // commit before it would go to a journal of the replaced snapshot
+    m_onAutosaved();
+}
+
+void ChangesTracker::m_autosave() {
+    // a half loaded board must not replace the file it comes from
+    if (!m_hasUnsavedChanges || m_autosaving || LoadJob::isLoading(m_context))
+        return;
+
+    // only documents that already have a file are autosaved, there is no one
+    // to ask for a path
+    Serializer serializer{};
+    QString fileName{serializer.getCurrentFilePath()};
+    if (fileName.isEmpty() || !QFile::exists(fileName))
+        return;
+
+    // while the journal is small, saving only has to mark its entries as saved
+    bool journaled{m_journal.isOpen() && m_journal.documentPath() == fileName};
+    if (journaled && m_journal.isComplete() && !m_journal.needsCompaction()) {
+        m_journal.view(m_context->spatialContext().offsetPos(),
+                       m_context->renderingContext().zoomFactor());
+        if (m_journal.commit()) {
+            markSaved();
+        }
+        return;
+    }
+
+    // the snapshot shares the point arrays with the items, everything else
+    // happens on the save thread
+    serializer.snapshot(m_context);
+    serializer.setPreset(Common::Utils::Compression::Profile::Fast);
+    m_autosaving = true;
+
+    m_pendingAutosave = Autosave{fileName, serializer.snapshotId(), m_generation};
+    if (journaled) {
+        m_pendingAutosave.journalOffset = m_journal.size();
+        m_pendingAutosave.journalSnapshotId = m_journal.snapshotId();
+    }
+
+    m_autosaveWritten = false;
+    m_savePool.start([this, serializer, fileName]() {
+        m_autosaveWritten = serializer.writeToFile(fileName);
+        QMetaObject::invokeMethod(this, [this]() { m_onAutosaved(); }, Qt::QueuedConnection);
+    });
+}
+
+void ChangesTracker::m_onAutosaved() {
+    // not running, or already finished by waitForAutosave()
+    if (!m_autosaving)
+        return;
+
+    m_autosaving = false;
+    const Autosave &autosave{m_pendingAutosave};
+
+    // another document may have been opened in the meantime
+    if (!m_autosaveWritten || Serializer{}.getCurrentFilePath() != autosave.fileName)
+        return;
+
+    bool unchanged{autosave.generation == m_generation};
+    if (autosave.journalOffset >= 0) {
+        // entries written while saving are carried over to the new snapshot
+        if (m_journal.documentPath() == autosave.fileName &&
+            m_journal.snapshotId() == autosave.journalSnapshotId) {
+            m_journal.rebase(autosave.snapshotId, autosave.journalOffset);
+        }
+    } else if (unchanged && !m_journal.isOpen()) {
+        // otherwise changes made while saving are in no journal, the next
+        // autosave writes the whole file again
+        m_journal.open(autosave.fileName, autosave.snapshotId);
+    }
+
+    if (unchanged) {
+        markSaved();
+    }
+}
@@ -19,8 +19,14 @@
 #pragma once
 
 #include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <memory>
 
+#include "../serializer/journal.hpp"
 class ApplicationContext;
+class Command;
 
 class ChangesTracker : public QObject {
     Q_OBJECT
@@ -33,14 +39,46 @@ public:
     void markSaved();
     void markChanged();
 
+    // the journal of the open document, closed while it has no binary file yet
+    Journal &journal();
+
+    // blocks until a running autosave is written and the journal rebased onto
+    // it, so it can not overwrite a newer save or take its commits
+    void waitForAutosave();
+
 signals:
     void changesStatusChanged(bool hasChanges);
 
 private slots:
-    void m_onCommandExecuted();
-    void m_onCommandUndone();
+    void m_onCommandExecuted(const std::shared_ptr<Command> &command);
+    void m_onCommandUndone(const std::shared_ptr<Command> &command);
+    void m_autosave();
 
 private:
+    struct Autosave {
+        QString fileName{};
+        quint64 snapshotId{};
+        quint64 generation{};
+
+        // size of the journal the snapshot was taken at, -1 if there was none
+        qint64 journalOffset{-1};
+        quint64 journalSnapshotId{};
+    };
+
+    // finishes the running autosave once it is written, called from the
+    // event loop or by waitForAutosave(), whichever comes first
+    void m_onAutosaved();
+
     ApplicationContext *m_context;
     bool m_hasUnsavedChanges;
+
+    // bumped on every change, an autosave only marks the document saved if
+    // nothing changed while it was being written
+    quint64 m_generation{0};
+    bool m_autosaving{false};
+    Autosave m_pendingAutosave{};
+    std::atomic<bool> m_autosaveWritten{false};  // set by the save thread
+    QTimer m_autosaveTimer{};
+    QThreadPool m_savePool{};
+    Journal m_journal{};
 };
\ No newline at end of file
@@ -21,22 +21,19 @@
 #include <QApplication>
 #include <QCheckBox>
 #include <QComboBox>
-#include <QDir>
-#include <QFile>
 #include <QFrame>
 #include <QHBoxLayout>
-#include <QJsonDocument>
 #include <QJsonObject>
 #include <QLabel>
 #include <QPalette>
 #include <QPushButton>
 #include <QScreen>
-#include <QStandardPaths>
 #include <QVBoxLayout>
 
 #include "../canvas/canvas.hpp"
 #include "../common/constants.hpp"
 #include "../common/renderitems.hpp"
+#include "../common/utils/settings.hpp"
 #include "../context/applicationcontext.hpp"
 #include "../context/renderingcontext.hpp"
 
@@ -245,52 +242,26 @@ void SettingsDialog::m_setupUI() {
     this->setLayout(mainLayout);
 }
 
-QString SettingsDialog::m_getSettingsFilePath() const {
-    // Build the path to the settings file in the ~/.config/drawy directory
-    QString drawyDirectoryPath{
-        QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) + "/drawy"};
-    QDir drawyDir{drawyDirectoryPath};
-
-    // Create the directory if it doesn't exist
-    if (!drawyDir.exists()) {
-        drawyDir.mkpath(".");
-    }
-
-    return drawyDir.filePath("settings.json");
-}
-
 void SettingsDialog::m_loadSettings() {
-    // Get the path to the settings file
-    QString settingsFilePath{m_getSettingsFilePath()};
-    QFile settingsFile{settingsFilePath};
-
     // Set default values for UI elements
     m_themeComboBox->setCurrentIndex(0);  // Auto mode by default
     m_restoreLastFileCheckBox->setChecked(false);
 
     // Read settings from file if it exists
-    if (settingsFile.open(QIODevice::ReadOnly)) {
-        QByteArray fileContent{settingsFile.readAll()};
-        settingsFile.close();
-
-        QJsonDocument settingsDocument{QJsonDocument::fromJson(fileContent)};
-        if (settingsDocument.isObject()) {
-            QJsonObject settingsObject{settingsDocument.object()};
-
-            // Load theme setting and set combo box index
-            QString themeValue{settingsObject.value("theme").toString("auto")};
-            int themeIndex{m_themeComboBox->findData(themeValue)};
-            if (themeIndex >= 0) {
-                m_themeComboBox->setCurrentIndex(themeIndex);
-            }
-
-            // Load restore last file setting
-            bool restoreLastFileEnabled{settingsObject.value("restoreLastFile").toBool(false)};
-            m_restoreLastFileCheckBox->setChecked(restoreLastFileEnabled);
-            m_restoreLastFile = restoreLastFileEnabled;
-        }
+    QJsonObject settingsObject{Common::Utils::Settings::load()};
+
+    // Load theme setting and set combo box index
+    QString themeValue{settingsObject.value("theme").toString("auto")};
+    int themeIndex{m_themeComboBox->findData(themeValue)};
+    if (themeIndex >= 0) {
+        m_themeComboBox->setCurrentIndex(themeIndex);
     }
 
+    // Load restore last file setting
+    bool restoreLastFileEnabled{settingsObject.value("restoreLastFile").toBool(false)};
+    m_restoreLastFileCheckBox->setChecked(restoreLastFileEnabled);
+    m_restoreLastFile = restoreLastFileEnabled;
+
     // Apply the loaded theme immediately
     Canvas &canvas{m_context->renderingContext().canvas()};
     QString currentTheme{m_themeComboBox->currentData().toString()};
@@ -315,33 +286,14 @@ void SettingsDialog::m_loadSettings() {
 }
 
 void SettingsDialog::m_saveSettings() {
-    QString settingsFilePath{m_getSettingsFilePath()};
-
-    QJsonObject settingsObject{};
-
     // Read existing settings to preserve other keys (e.g., lastOpenedFile)
-    QFile settingsFile{settingsFilePath};
-    if (settingsFile.exists() && settingsFile.open(QIODevice::ReadOnly)) {
-        QByteArray fileContent{settingsFile.readAll()};
-        settingsFile.close();
-
-        QJsonDocument existingSettingsDoc{QJsonDocument::fromJson(fileContent)};
-        if (existingSettingsDoc.isObject()) {
-            settingsObject = existingSettingsDoc.object();
-        }
-    }
+    QJsonObject settingsObject{Common::Utils::Settings::load()};
 
     // Update the settings we manage in this dialog
     settingsObject["theme"] = m_themeComboBox->currentData().toString();
     settingsObject["restoreLastFile"] = m_restoreLastFileCheckBox->isChecked();
 
-    QJsonDocument settingsDocument{settingsObject};
-
-    // Write settings back to file
-    if (settingsFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        settingsFile.write(settingsDocument.toJson());
-        settingsFile.close();
-    }
+    Common::Utils::Settings::save(settingsObject);
 
     m_restoreLastFile = m_restoreLastFileCheckBox->isChecked();
 
@@ -43,7 +43,6 @@ private:
     void m_setupUI();
     void m_loadSettings();
     void m_saveSettings();
-    QString m_getSettingsFilePath() const;
 
     ApplicationContext *m_context{nullptr};
     QComboBox *m_themeComboBox{nullptr};
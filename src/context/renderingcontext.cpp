@@ -19,8 +19,11 @@
 #include "renderingcontext.hpp"
 
 #include <QScreen>
+#include <algorithm>
 
 #include "../canvas/canvas.hpp"
+#include "../common/constants.hpp"
+#include "../common/profiler.hpp"
 #include "../common/renderitems.hpp"
 #include "../data-structures/cachegrid.hpp"
 #include "applicationcontext.hpp"
@@ -33,6 +36,7 @@ RenderingContext::RenderingContext(ApplicationContext *context)
 
 RenderingContext::~RenderingContext() {
     qDebug() << "Object deleted: RenderingContext";
+    m_renderPool.waitForDone();
     delete m_canvasPainter;
 }
 
@@ -45,28 +49,69 @@ void RenderingContext::setRenderingContext() {
     QObject::connect(m_canvas, &Canvas::destroyed, this, &RenderingContext::endPainters);
     QObject::connect(m_canvas, &Canvas::resizeStart, this, &RenderingContext::endPainters);
     QObject::connect(m_canvas, &Canvas::resizeEnd, this, &RenderingContext::beginPainters);
-    QObject::connect(m_canvas, &Canvas::resizeEventCalled, this, &RenderingContext::canvasResized);
+
+    // frames are only drawn when something asked for one, see scheduleFrame()
+    m_frameTimer.setSingleShot(true);
+    m_frameTimer.setTimerType(Qt::PreciseTimer);
 
     QObject::connect(&m_frameTimer, &QTimer::timeout, m_canvas, [&]() {
+        Profiler &profiler{Profiler::instance()};
+        qint64 frameStart{profiler.enabled() ? profiler.now() : -1};
+        m_lastFrame.start();
+
         if (m_needsReRender) {
-            Common::renderCanvas(m_applicationContext);
-            m_needsReRender = false;
+            int budget{std::max(1, static_cast<int>(Common::renderBudget * 1000 / fps()))};
+            m_needsReRender = !Common::renderCanvas(m_applicationContext, budget);
+
+            // show the progress of a partially rendered frame on the whole canvas
+            if (m_needsReRender) {
+                m_needsUpdate = true;
+                m_fullUpdate = true;
+            }
         }
 
+        // QWidget::update() coalesces repaints and Qt paints in sync with the screen
         if (m_needsUpdate) {
-            if (m_updateRegion.width() == 0 || m_updateRegion.height() == 0) {
+            if (m_fullUpdate || m_updateRegion.isEmpty()) {
                 m_canvas->update();
             } else {
                 m_canvas->update(m_updateRegion);
             }
 
-            m_updateRegion.setWidth(0);
-            m_updateRegion.setHeight(0);
+            m_updateRegion = {};
+            m_fullUpdate = false;
             m_needsUpdate = false;
         }
+
+        if (frameStart >= 0 && profiler.enabled()) {
+            qint64 duration{profiler.now() - frameStart};
+            profiler.record("frame", frameStart, duration);
+            profiler.set(Profiler::PixmapBytes, pixmapBytes());
+            profiler.endFrame(duration);
+
+            if (profiler.overlayVisible())
+                m_canvas->update(m_canvas->hudRect());
+        }
+
+        // the rest of a frame that ran out of budget
+        if (m_needsReRender)
+            scheduleFrame();
     });
 
-    m_frameTimer.start(1000 / fps());
+    m_lastFrame.start();
+    if (m_needsReRender || m_needsUpdate)
+        scheduleFrame();
+}
+
+// Asks for a frame, requests made before it is drawn are coalesced into it.
+// Frames are at least one refresh interval apart, the first one after an idle
+// period is drawn right away.
+void RenderingContext::scheduleFrame() {
+    if (m_frameTimer.isActive() || m_canvas == nullptr)
+        return;
+
+    qint64 interval{1000 / std::max(fps(), 1)};
+    m_frameTimer.start(static_cast<int>(std::max<qint64>(0, interval - m_lastFrame.elapsed())));
 }
 
 Canvas &RenderingContext::canvas() const {
@@ -81,6 +126,20 @@ QPainter &RenderingContext::overlayPainter() const {
     return *m_overlayPainter;
 }
 
+QThreadPool &RenderingContext::renderPool() {
+    return m_renderPool;
+}
+
+// memory held by the canvas pixmaps and the cached cells
+qint64 RenderingContext::pixmapBytes() const {
+    auto bytes = [](const QPixmap *pixmap) -> qint64 {
+        return pixmap ? qint64{pixmap->width()} * pixmap->height() * pixmap->depth() / 8 : 0;
+    };
+
+    return bytes(m_canvas->canvas()) + bytes(m_canvas->overlay()) +
+           m_applicationContext->spatialContext().cacheGrid().memoryUsage();
+}
+
 // PRIVATE SLOTS
 void RenderingContext::endPainters() {
     if (m_canvasPainter->isActive())
@@ -133,7 +192,8 @@ void RenderingContext::updateZoomFactor(qreal diff, QPoint center) {
     endPainters();
     beginPainters();
 
-    m_applicationContext->spatialContext().cacheGrid().markAllDirty();
+    // cells of the previous zoom level stay cached
+    m_applicationContext->spatialContext().cacheGrid().setZoomFactor(m_zoomFactor);
 
     m_applicationContext->renderingContext().markForRender();
     m_applicationContext->renderingContext().markForUpdate();
@@ -141,6 +201,7 @@ void RenderingContext::updateZoomFactor(qreal diff, QPoint center) {
 
 void RenderingContext::setZoomFactor(qreal newValue) {
     m_zoomFactor = newValue;
+    m_applicationContext->spatialContext().cacheGrid().setZoomFactor(newValue);
 }
 
 const int RenderingContext::fps() const {
@@ -152,26 +213,21 @@ const int RenderingContext::fps() const {
     return 60;
 }
 
-void RenderingContext::canvasResized() {
-    int width{m_canvas->dimensions().width()}, height{m_canvas->dimensions().height()};
-    int cellW{CacheCell::cellSize().width()}, cellH{CacheCell::cellSize().height()};
-    int rows{static_cast<int>(std::ceil(height / static_cast<double>(cellH)) + 1)};
-    int cols{static_cast<int>(std::ceil(width / static_cast<double>(cellW)) + 1)};
-
-    m_applicationContext->spatialContext().cacheGrid().setSize(9 * rows * cols);
-}
-
 void RenderingContext::markForRender() {
     m_needsReRender = true;
+    scheduleFrame();
 }
 
 void RenderingContext::markForUpdate() {
     m_needsUpdate = true;
+    m_fullUpdate = true;
+    scheduleFrame();
 }
 
 void RenderingContext::markForUpdate(const QRect &region) {
     m_needsUpdate = true;
-    m_updateRegion = region;
+    m_updateRegion = m_updateRegion.united(region);
+    scheduleFrame();
 }
 
 void RenderingContext::reset() {
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QThreadPool>
 #include <QTimer>
 #include <QWidget>
 class Canvas;
@@ -36,6 +38,7 @@ public:
     Canvas &canvas() const;
     QPainter &canvasPainter() const;
     QPainter &overlayPainter() const;
+    QThreadPool &renderPool();
 
     void markForRender();
     void markForUpdate();
@@ -52,18 +55,25 @@ public:
 private slots:
     void beginPainters();
     void endPainters();
-    void canvasResized();
 
 private:
+    void scheduleFrame();
+    qint64 pixmapBytes() const;
+
     Canvas *m_canvas{nullptr};
     QPainter *m_canvasPainter{};
     QPainter *m_overlayPainter{};
 
     QTimer m_frameTimer;
+    QElapsedTimer m_lastFrame{};
+
+    // rasterizes dirty cache cells, see Common::renderCanvas
+    QThreadPool m_renderPool{};
 
     bool m_needsReRender{false};
     bool m_needsUpdate{false};
-    QRect m_updateRegion{};
+    bool m_fullUpdate{false};
+    QRect m_updateRegion{};  // united regions of markForUpdate(region)
 
     qreal m_zoomFactor{1};
 
@@ -37,7 +37,7 @@ SelectionContext::~SelectionContext() {
     qDebug() << "Object deleted: SelectionContext";
 }
 
-std::unordered_set<std::shared_ptr<Item>> &SelectionContext::selectedItems() {
+ItemSet &SelectionContext::selectedItems() {
     return m_selectedItems;
 }
 
@@ -19,7 +19,8 @@
 #pragma once
 
 #include <QWidget>
-#include <unordered_set>
+
+#include "../data-structures/itemset.hpp"
 class Property;
 class Tool;
 class Item;
@@ -30,7 +31,7 @@ public:
     SelectionContext(ApplicationContext *context);
     ~SelectionContext() override;
 
-    std::unordered_set<std::shared_ptr<Item>> &selectedItems();
+    ItemSet &selectedItems();
     QRectF selectionBox() const;
 
     void reset();
@@ -39,7 +40,7 @@ public slots:
     void updatePropertyOfSelectedItems(const Property& property);
 
 private:
-    std::unordered_set<std::shared_ptr<Item>> m_selectedItems{};
+    ItemSet m_selectedItems{};
 
     ApplicationContext *m_applicationContext;
 };
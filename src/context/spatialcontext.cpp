@@ -18,10 +18,13 @@
 
 #include "spatialcontext.hpp"
 
+#include <algorithm>
 #include <memory>
 
 #include "../canvas/canvas.hpp"
 #include "../command/commandhistory.hpp"
+#include "../common/constants.hpp"
+#include "../common/utils/settings.hpp"
 #include "../data-structures/cachegrid.hpp"
 #include "../data-structures/quadtree.hpp"
 #include "applicationcontext.hpp"
@@ -42,7 +45,10 @@ void SpatialContext::setSpatialContext() {
 
     m_quadtree = std::make_unique<QuadTree>(QRect{{0, 0}, canvas.sizeHint()}, 100);
     m_coordinateTransformer = std::make_unique<CoordinateTransformer>(m_applicationContext);
-    m_cacheGrid = std::make_unique<CacheGrid>(100);
+    qint64 cacheBudget{Common::Utils::Settings::load()
+                           .value("cacheBudget")
+                           .toInteger(Common::defaultCacheBudget)};
+    m_cacheGrid = std::make_unique<CacheGrid>(std::max<qint64>(cacheBudget, 1) * 1024 * 1024);
     m_commandHistory = std::make_unique<CommandHistory>(m_applicationContext);
 }
 
@@ -72,7 +78,7 @@ void SpatialContext::setOffsetPos(const QPointF &pos) {
 
 void SpatialContext::reset() {
     quadtree().clear();
-    cacheGrid().markAllDirty();
+    cacheGrid().clear();
     commandHistory().clear();
     setOffsetPos(QPointF{0, 0});
 }
@@ -142,29 +142,11 @@ void UIContext::setUIContext() {
     QObject::connect(&m_actionBar->button(BUTTON_ID_SAVE_AS),
                      &QPushButton::clicked,
                      this,
-                     [this]() {
-                         Serializer serializer{};
-                         serializer.serialize(m_applicationContext);
-                         if (serializer.saveToFile()) {
-                             m_notificationLabel->showMessage("File saved successfully!");
-                             m_changesTracker->markSaved();
-                         }
-                     });
+                     [this]() { m_actionManager->saveToFile(); });
 
     // Save: Save drawing directly to the currently open file
     QObject::connect(&m_actionBar->button(BUTTON_ID_SAVE), &QPushButton::clicked, this, [this]() {
-        Serializer serializer{};
-        serializer.serialize(m_applicationContext);
-        if (serializer.saveCurrentFile()) {
-            m_notificationLabel->showMessage("File saved successfully!");
-            m_changesTracker->markSaved();
-        } else {
-            // If no current file exists, fall back to Save As dialog
-            if (serializer.saveToFile()) {
-                m_notificationLabel->showMessage("File saved successfully!");
-                m_changesTracker->markSaved();
-            }
-        }
+        m_actionManager->saveCurrentFile();
     });
 
     // Open File: Load a drawing from disk
@@ -288,11 +270,13 @@ bool UIContext::promptSaveBeforeClose() {
     
     if (clickedButton == saveButton) {
         Serializer serializer{};
-        serializer.serialize(m_applicationContext);
-        if (!serializer.saveCurrentFile()) {
-            // If no current file, show save dialog
-            if (!serializer.saveToFile()) {
-                return false;  // User cancelled save dialog
+        if (!serializer.commitJournal(m_applicationContext)) {
+            serializer.serialize(m_applicationContext);
+            if (!serializer.saveCurrentFile()) {
+                // If no current file, show save dialog
+                if (!serializer.saveToFile()) {
+                    return false;  // User cancelled save dialog
+                }
             }
         }
         m_changesTracker->markSaved();
@@ -19,21 +19,19 @@
 #include "cachegrid.hpp"
 
 #include <QDebug>
-#include <QPainter>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
-int CacheCell::counter = 0;
-
-CacheCell::CacheCell(const QPoint &point) : m_point{point}, m_dirty(true) {
-    m_image = std::make_unique<QPixmap>(CacheCell::cellSize());
-    m_image->fill(Qt::transparent);
+#include "../common/profiler.hpp"
 
-    m_painter = std::make_unique<QPainter>(m_image.get());
-    m_painter->setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
-    m_painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
-    m_painter->setClipRegion(m_image->rect());
+int CacheCell::counter = 0;
 
+CacheCell::CacheCell(int level, const QPoint &point)
+    : m_level{level},
+      m_point{point},
+      m_dirty(true) {
     CacheCell::counter++;
-    
 }
 
 CacheCell::~CacheCell() {
@@ -44,12 +42,16 @@ const QPoint &CacheCell::point() const {
     return m_point;
 }
 
+int CacheCell::level() const {
+    return m_level;
+}
+
 bool CacheCell::dirty() const {
     return m_dirty;
 }
 
-QPixmap &CacheCell::image() const {
-    return *m_image;
+QImage &CacheCell::image() {
+    return m_image;
 }
 
 QRect CacheCell::rect() const {
@@ -62,28 +64,66 @@ void CacheCell::setDirty(bool dirty) {
     m_dirty = dirty;
 }
 
-QPainter &CacheCell::painter() const {
-    return *m_painter;
+bool CacheCell::rendered() const {
+    return m_rendered;
+}
+
+void CacheCell::setRendered(bool rendered) {
+    m_rendered = rendered;
+}
+
+bool CacheCell::empty() const {
+    return m_image.isNull();
+}
+
+// the bookkeeping of a cell counts too, so empty cells can not pile up forever
+qint64 CacheCell::sizeInBytes() const {
+    return static_cast<qint64>(sizeof(CacheCell)) + m_image.sizeInBytes();
 }
 
 QSize CacheCell::cellSize() {
     return {500, 500};
 }
 
-CacheGrid::CacheGrid(int maxSize) {
+// zoom factors are bucketed to hundredths, so the same zoom always maps to
+// the same level regardless of floating point error
+int CacheGrid::zoomLevel(qreal zoomFactor) {
+    return qRound(zoomFactor * 100);
+}
+
+qreal CacheGrid::zoomFactor(int level) {
+    return level / 100.0;
+}
+
+CacheGrid::CacheGrid(qint64 maxBytes) {
     m_headCell->nextCell = m_tailCell;
     m_tailCell->prevCell = m_headCell;
 
-    if (maxSize == 0) {
-        throw std::logic_error("maxSize can not be zero for the cache grid");
-    }
-    m_maxSize = maxSize;
+    setMemoryBudget(maxBytes);
 }
 
 CacheGrid::~CacheGrid() {
     qDebug() << "Object deleted: CacheGrid";
 }
 
+void CacheGrid::setZoomFactor(qreal zoomFactor) {
+    int level{zoomLevel(zoomFactor)};
+    if (level != m_level) {
+        m_previousLevel = m_level;
+        m_level = level;
+    }
+
+    m_zoomFactor = zoomFactor;
+}
+
+int CacheGrid::level() const {
+    return m_level;
+}
+
+int CacheGrid::previousLevel() const {
+    return m_previousLevel;
+}
+
 QVector<std::shared_ptr<CacheCell>> CacheGrid::queryCells(const QRect &rect) {
     QPoint topLeft{rect.topLeft()}, bottomRight{rect.bottomRight()};
 
@@ -102,34 +142,84 @@ QVector<std::shared_ptr<CacheCell>> CacheGrid::queryCells(const QRect &rect) {
     return out;
 }
 
+// Returns the cells of `level` that are already cached, without creating
+// cells or touching the LRU order. `rect` is in the grid coordinates of `level`.
+QVector<std::shared_ptr<CacheCell>> CacheGrid::cachedCells(int level, const QRect &rect) const {
+    QVector<std::shared_ptr<CacheCell>> out{};
+    if (!m_levelSizes.contains(level)) {
+        return out;
+    }
+
+    QPoint topLeft{rect.topLeft()}, bottomRight{rect.bottomRight()};
+
+    int cellMinX = floor(static_cast<double>(topLeft.x()) / CacheCell::cellSize().width());
+    int cellMinY = floor(static_cast<double>(topLeft.y()) / CacheCell::cellSize().height());
+    int cellMaxX = floor(static_cast<double>(bottomRight.x()) / CacheCell::cellSize().width());
+    int cellMaxY = floor(static_cast<double>(bottomRight.y()) / CacheCell::cellSize().height());
+
+    for (int row = cellMinX; row <= cellMaxX; row++) {
+        for (int col = cellMinY; col <= cellMaxY; col++) {
+            std::shared_ptr<CacheCell> cur{m_grid.value(Key{level, QPoint{row, col}})};
+            if (cur) {
+                out.push_back(cur);
+            }
+        }
+    }
+
+    return out;
+}
+
+// converts a rect in the grid coordinates of the current level to `level`
+QRect CacheGrid::levelRect(const QRect &rect, int level) const {
+    if (level == m_level) {
+        return rect;
+    }
+
+    qreal scale{zoomFactor(level) / m_zoomFactor};
+    QRectF scaled{rect.x() * scale, rect.y() * scale, rect.width() * scale, rect.height() * scale};
+    return scaled.toAlignedRect();
+}
+
 void CacheGrid::markDirty(const QRect &rect) {
-    QVector<std::shared_ptr<CacheCell>> dirtyCells{queryCells(rect)};
-    for (const std::shared_ptr<CacheCell>& cell : dirtyCells) {
-        cell->setDirty(true);
+    for (auto it{m_levelSizes.cbegin()}; it != m_levelSizes.cend(); it++) {
+        QVector<std::shared_ptr<CacheCell>> dirtyCells{cachedCells(it.key(), levelRect(rect, it.key()))};
+        for (const std::shared_ptr<CacheCell>& cell : dirtyCells) {
+            cell->setDirty(true);
+        }
     }
 }
 
-std::shared_ptr<CacheCell> CacheGrid::cell(const QPoint &point) {
-    std::shared_ptr<CacheCell> cur{};
-    if (!m_grid.contains(point) || !m_grid[point]) {
-        if (m_curSize == m_maxSize) {
-            // deleting least recently used cell
-            std::shared_ptr<CacheCell> temp{m_headCell->nextCell};
-            m_headCell->nextCell = temp->nextCell;
-            if (auto next = temp->nextCell.lock()) {
-                next->prevCell = m_headCell;
-            }
-            m_grid[temp->point()] = nullptr;
-            m_grid.remove(temp->point());
-            temp.reset();
-            m_curSize--;
+// like markDirty(), but leaves the cells of the current level untouched
+void CacheGrid::markOtherLevelsDirty(const QRect &rect) {
+    for (auto it{m_levelSizes.cbegin()}; it != m_levelSizes.cend(); it++) {
+        if (it.key() == m_level)
+            continue;
+
+        QVector<std::shared_ptr<CacheCell>> dirtyCells{cachedCells(it.key(), levelRect(rect, it.key()))};
+        for (const std::shared_ptr<CacheCell>& cell : dirtyCells) {
+            cell->setDirty(true);
         }
+    }
+}
+
+std::shared_ptr<CacheCell> CacheGrid::cell(const QPoint &point) {
+    Key key{m_level, point};
 
-        cur = std::make_shared<CacheCell>(point);
-        m_grid[point] = cur;
+    std::shared_ptr<CacheCell> cur{};
+    bool created{false};
+    if (!m_grid.contains(key) || !m_grid[key]) {
+        cur = std::make_shared<CacheCell>(m_level, point);
+        m_grid[key] = cur;
+        m_levelSizes[m_level]++;
         m_curSize++;
+
+        m_curBytes += cur->sizeInBytes();
+        m_peakBytes = std::max(m_peakBytes, m_curBytes);
+        created = true;
+        Profiler::instance().add(Profiler::CacheMisses);
     } else {
-        cur = m_grid[point];
+        cur = m_grid[key];
+        Profiler::instance().add(Profiler::CacheHits);
         if (auto prev = cur->prevCell.lock()) {
             prev->nextCell = cur->nextCell;
         }
@@ -144,15 +234,95 @@ std::shared_ptr<CacheCell> CacheGrid::cell(const QPoint &point) {
     }
     m_tailCell->prevCell = cur;
 
+    if (created) {
+        evict(cur);
+    }
+
     return cur;
 }
 
+// gives the cell an image to draw on, which counts towards the memory budget
+void CacheGrid::allocate(CacheCell &cell) {
+    if (!cell.empty()) {
+        return;
+    }
+
+    qint64 oldBytes{cell.sizeInBytes()};
+    cell.m_image = QImage{CacheCell::cellSize(), QImage::Format_ARGB32_Premultiplied};
+
+    // the cell may have been evicted already, in which case it is not counted
+    std::shared_ptr<CacheCell> keep{m_grid.value(Key{cell.level(), cell.point()})};
+    if (keep.get() != &cell) {
+        return;
+    }
+
+    m_curBytes += cell.sizeInBytes() - oldBytes;
+    m_peakBytes = std::max(m_peakBytes, m_curBytes);
+    evict(keep);
+}
+
+void CacheGrid::release(CacheCell &cell) {
+    if (cell.empty()) {
+        return;
+    }
+
+    qint64 oldBytes{cell.sizeInBytes()};
+    cell.m_image = QImage{};
+
+    if (m_grid.value(Key{cell.level(), cell.point()}).get() == &cell) {
+        m_curBytes -= oldBytes - cell.sizeInBytes();
+    }
+}
+
+// deletes least recently used cells, of any level, until the cache fits in
+// its budget again, `keep` is never deleted
+void CacheGrid::evict(const std::shared_ptr<CacheCell> &keep) {
+    while (m_curBytes > m_maxBytes) {
+        std::shared_ptr<CacheCell> temp{m_headCell->nextCell};
+        if (temp == m_tailCell || temp == keep) {
+            break;
+        }
+
+        m_headCell->nextCell = temp->nextCell;
+        if (auto next = temp->nextCell.lock()) {
+            next->prevCell = m_headCell;
+        }
+
+        Key tempKey{temp->level(), temp->point()};
+        m_grid.remove(tempKey);
+        if (--m_levelSizes[tempKey.level] == 0) {
+            m_levelSizes.remove(tempKey.level);
+        }
+
+        m_curBytes -= temp->sizeInBytes();
+        m_curSize--;
+        Profiler::instance().add(Profiler::CacheEvictions);
+    }
+}
+
 int CacheGrid::size() const {
     return m_curSize;
 }
 
-void CacheGrid::setSize(int newSize) {
-    m_maxSize = newSize;
+void CacheGrid::setMemoryBudget(qint64 maxBytes) {
+    if (maxBytes <= 0) {
+        throw std::logic_error("The memory budget of the cache grid must be positive");
+    }
+
+    m_maxBytes = maxBytes;
+    evict(nullptr);
+}
+
+qint64 CacheGrid::memoryBudget() const {
+    return m_maxBytes;
+}
+
+qint64 CacheGrid::memoryUsage() const {
+    return m_curBytes;
+}
+
+qint64 CacheGrid::peakMemoryUsage() const {
+    return m_peakBytes;
 }
 
 void CacheGrid::markAllDirty() {
@@ -160,3 +330,13 @@ void CacheGrid::markAllDirty() {
         cell->setDirty(true);
     }
 }
+
+// drops every cell, unlike markAllDirty() no stale contents are left to show
+void CacheGrid::clear() {
+    m_grid.clear();
+    m_levelSizes.clear();
+    m_headCell->nextCell = m_tailCell;
+    m_tailCell->prevCell = m_headCell;
+    m_curSize = 0;
+    m_curBytes = 0;
+}
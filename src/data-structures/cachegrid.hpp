@@ -18,8 +18,9 @@
 
 #pragma once
 #include <QHash>
-#include <QPixmap>
+#include <QImage>
 #include <QPoint>
+#include <memory>
 
 class CacheGrid;
 
@@ -29,46 +30,102 @@ public:
     static QSize cellSize();
     static int counter;
 
-    CacheCell(const QPoint &point);
+    CacheCell(int level, const QPoint &point);
     ~CacheCell();
 
     QRect rect() const;
     const QPoint &point() const;
+    int level() const;
     bool dirty() const;
     void setDirty(bool dirty);
-    QPixmap &image() const;
-    QPainter &painter() const;
+    bool rendered() const;
+    void setRendered(bool rendered);
+    QImage &image();
+    bool empty() const;
+    qint64 sizeInBytes() const;
 
 private:
+    int m_level{};
     QPoint m_point{};
-    std::unique_ptr<QPixmap> m_image{nullptr};
-    std::unique_ptr<QPainter> m_painter{};
+    // QImage rather than QPixmap so cells can be painted from worker threads,
+    // null while no item lands in the cell, see CacheGrid::allocate()
+    QImage m_image{};
     std::weak_ptr<CacheCell> nextCell{};
     std::weak_ptr<CacheCell> prevCell{};
     bool m_dirty{};
+    // whether the image was ever drawn, stale contents are still better than nothing
+    bool m_rendered{false};
 
     // CacheGrid can access private members
     friend CacheGrid;
 };
 
+/*
+ * Cells are cached per zoom level (a pyramid keyed by level, x and y) so that
+ * zooming back to a recent level reuses its cells. Every level shares the same
+ * LRU list and memory budget, least recently used cells are evicted once the
+ * images of all cells take more than `maxBytes`. Rects passed to the grid are
+ * always in the grid coordinates of the current level.
+ */
 class CacheGrid {
 public:
-    CacheGrid(int maxSize);
+    static int zoomLevel(qreal zoomFactor);
+    static qreal zoomFactor(int level);
+
+    CacheGrid(qint64 maxBytes);
     ~CacheGrid();
 
+    void setZoomFactor(qreal zoomFactor);
+    int level() const;
+    int previousLevel() const;
+
     QVector<std::shared_ptr<CacheCell>> queryCells(const QRect &rect);
+    QVector<std::shared_ptr<CacheCell>> cachedCells(int level, const QRect &rect) const;
     std::shared_ptr<CacheCell> cell(const QPoint &point);
+    void allocate(CacheCell &cell);
+    void release(CacheCell &cell);
     void markDirty(const QRect &rect);
+    void markOtherLevelsDirty(const QRect &rect);
     void markAllDirty();
-    void setSize(int newSize);
+    void clear();
     int size() const;
 
+    void setMemoryBudget(qint64 maxBytes);
+    qint64 memoryBudget() const;
+    qint64 memoryUsage() const;
+    qint64 peakMemoryUsage() const;
+
 private:
-    QHash<QPoint, std::shared_ptr<CacheCell>> m_grid{};
-    std::shared_ptr<CacheCell> m_headCell{std::make_shared<CacheCell>(QPoint{0, 0})};
-    std::shared_ptr<CacheCell> m_tailCell{std::make_shared<CacheCell>(QPoint{0, 0})};
+    struct Key {
+        int level{};
+        QPoint point{};
+
+        bool operator==(const Key &other) const {
+            return level == other.level && point == other.point;
+        }
+
+        friend size_t qHash(const Key &key, size_t seed = 0) {
+            return qHashMulti(seed, key.level, key.point);
+        }
+    };
+
+    QRect levelRect(const QRect &rect, int level) const;
+    void evict(const std::shared_ptr<CacheCell> &keep);
+
+    QHash<Key, std::shared_ptr<CacheCell>> m_grid{};
+    // number of cached cells of every level
+    QHash<int, int> m_levelSizes{};
+    std::shared_ptr<CacheCell> m_headCell{std::make_shared<CacheCell>(0, QPoint{0, 0})};
+    std::shared_ptr<CacheCell> m_tailCell{std::make_shared<CacheCell>(0, QPoint{0, 0})};
 
     QSize m_cellSize{};
     int m_curSize{0};
-    int m_maxSize{0};
+
+    qint64 m_curBytes{0};
+    qint64 m_peakBytes{0};
+    qint64 m_maxBytes{0};
+
+    qreal m_zoomFactor{1};
+    int m_level{zoomLevel(1)};
+    int m_previousLevel{zoomLevel(1)};
 };
@@ -0,0 +1,86 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "itemregistry.hpp"
+
+#include <stdexcept>
+
+ItemRegistry *ItemRegistry::m_instance = nullptr;
+
+ItemHandle::ItemHandle(quint32 index, quint32 generation)
+    : m_value{(generation << indexBits) | (index & indexMask)} {
+}
+
+ItemHandle ItemRegistry::acquire(Item *item) {
+    quint32 index{};
+
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        // the last index is reserved, it would collide with the invalid handle
+        if (m_items.size() >= ItemHandle::indexMask) {
+            throw std::runtime_error("Item registry is out of handles");
+        }
+
+        index = static_cast<quint32>(m_items.size());
+        m_items.push_back(nullptr);
+        m_generations.push_back(0);
+    }
+
+    m_items[index] = item;
+    return ItemHandle{index, m_generations[index]};
+}
+
+void ItemRegistry::release(ItemHandle handle) {
+    if (!contains(handle)) {
+        return;
+    }
+
+    quint32 index{handle.index()};
+    m_items[index] = nullptr;
+
+    // bump the generation so stale handles stop resolving
+    m_generations[index] = (m_generations[index] + 1) & ItemHandle::maxGeneration;
+    m_freeSlots.push_back(index);
+}
+
+Item *ItemRegistry::item(ItemHandle handle) const {
+    if (!contains(handle)) {
+        return nullptr;
+    }
+
+    return m_items[handle.index()];
+}
+
+bool ItemRegistry::contains(ItemHandle handle) const {
+    if (!handle.isValid() || handle.index() >= m_items.size()) {
+        return false;
+    }
+
+    quint32 index{handle.index()};
+    return m_items[index] != nullptr && m_generations[index] == handle.generation();
+}
+
+quint32 ItemRegistry::capacity() const {
+    return static_cast<quint32>(m_items.size());
+}
+
+quint32 ItemRegistry::size() const {
+    return static_cast<quint32>(m_items.size() - m_freeSlots.size());
+}
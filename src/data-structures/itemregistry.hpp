@@ -0,0 +1,94 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+class Item;
+
+/*
+ * A 32 bit handle to a live item. The lower bits index a slot in the
+ * ItemRegistry and the upper bits hold the generation of that slot, so a
+ * handle to a deleted item never resolves to an item created later in the
+ * same slot.
+ */
+class ItemHandle {
+public:
+    static constexpr int indexBits{22};
+    static constexpr quint32 indexMask{(1u << indexBits) - 1};
+    static constexpr quint32 maxGeneration{(1u << (32 - indexBits)) - 1};
+
+    ItemHandle() = default;
+    ItemHandle(quint32 index, quint32 generation);
+
+    quint32 index() const { return m_value & indexMask; }
+    quint32 generation() const { return m_value >> indexBits; }
+    quint32 value() const { return m_value; }
+    bool isValid() const { return m_value != invalid; }
+
+    bool operator==(const ItemHandle &other) const { return m_value == other.m_value; }
+    bool operator!=(const ItemHandle &other) const { return m_value != other.m_value; }
+
+private:
+    static constexpr quint32 invalid{0xFFFFFFFF};
+
+    quint32 m_value{invalid};
+};
+
+/*
+ * Hands out dense handles to items. Every item acquires a slot when it is
+ * constructed and releases it when it is destroyed, so data structures can
+ * store per item data in contiguous arrays indexed by `ItemHandle::index()`
+ * instead of hash maps keyed on item pointers.
+ *
+ * NOTE: This is not thread safe, items must be created and destroyed on the
+ * GUI thread.
+ */
+class ItemRegistry {
+public:
+    static ItemRegistry &instance() {
+        if (!m_instance) {
+            m_instance = new ItemRegistry();
+        }
+
+        return *m_instance;
+    }
+
+    ItemHandle acquire(Item *item);
+    void release(ItemHandle handle);
+
+    Item *item(ItemHandle handle) const;
+    bool contains(ItemHandle handle) const;
+
+    // upper bound of every handle index given out so far
+    quint32 capacity() const;
+    quint32 size() const;
+
+private:
+    ItemRegistry() = default;
+
+    ItemRegistry(const ItemRegistry &) = delete;
+    ItemRegistry &operator=(const ItemRegistry &) = delete;
+
+    std::vector<Item *> m_items{};
+    std::vector<quint32> m_generations{};
+    std::vector<quint32> m_freeSlots{};
+
+    static ItemRegistry *m_instance;
+};
@@ -0,0 +1,83 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "itemset.hpp"
+
+#include "../item/item.hpp"
+
+bool ItemSet::insert(const ItemPtr &item) {
+    if (contains(item)) {
+        return false;
+    }
+
+    quint32 index{item->handle().index()};
+    if (index >= m_positions.size()) {
+        m_positions.resize(std::max<std::size_t>(index + 1, ItemRegistry::instance().capacity()));
+    }
+
+    m_positions[index] = m_items.size();
+    m_items.push_back(item);
+    return true;
+}
+
+bool ItemSet::erase(const ItemPtr &item) {
+    if (!contains(item)) {
+        return false;
+    }
+
+    // move the last member into the hole
+    qsizetype position{m_positions[item->handle().index()]};
+    if (position != m_items.size() - 1) {
+        m_items[position] = std::move(m_items.back());
+        m_positions[m_items[position]->handle().index()] = position;
+    }
+    m_items.pop_back();
+
+    return true;
+}
+
+bool ItemSet::contains(const ItemPtr &item) const {
+    quint32 index{item->handle().index()};
+    if (index >= m_positions.size()) {
+        return false;
+    }
+
+    // stale positions are harmless, they either point past the end or to another item
+    qsizetype position{m_positions[index]};
+    return position < m_items.size() && m_items[position] == item;
+}
+
+void ItemSet::clear() {
+    m_items.clear();
+}
+
+bool ItemSet::empty() const {
+    return m_items.empty();
+}
+
+qsizetype ItemSet::size() const {
+    return m_items.size();
+}
+
+ItemSet::const_iterator ItemSet::begin() const {
+    return m_items.cbegin();
+}
+
+ItemSet::const_iterator ItemSet::end() const {
+    return m_items.cend();
+}
@@ -0,0 +1,60 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <memory>
+#include <vector>
+class Item;
+
+/*
+ * A set of items backed by two arrays (a sparse set): `m_items` stores the
+ * members contiguously and `m_positions`, indexed by the item's handle, stores
+ * where each member lives in `m_items`. Lookups, insertions and removals are
+ * O(1) without hashing and iteration walks a plain array.
+ */
+class ItemSet {
+public:
+    using ItemPtr = std::shared_ptr<Item>;
+    using const_iterator = QVector<ItemPtr>::const_iterator;
+
+    ItemSet() = default;
+
+    template <typename Iterator>
+    ItemSet(Iterator first, Iterator last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    bool insert(const ItemPtr &item);
+    bool erase(const ItemPtr &item);
+    bool contains(const ItemPtr &item) const;
+    void clear();
+
+    bool empty() const;
+    qsizetype size() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    QVector<ItemPtr> m_items{};
+    std::vector<qsizetype> m_positions{};
+};
@@ -19,20 +19,106 @@
 #include "orderedlist.hpp"
 
 #include <QDebug>
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
+#include <utility>
+
+#include "../item/group.hpp"
+#include "../item/item.hpp"
 
 OrderedList::~OrderedList() {
     qDebug() << "Object deleted: OrderedList";
 }
 
-bool OrderedList::hasItem(const ItemPtr& item) const {
-    if (m_itemIterMap.find(item) == m_itemIterMap.end()) {
-        return false;
+// inserts the node at `index` before the node at `before`, or at the back if
+// `before` is npos
+void OrderedList::link(quint32 index, quint32 before) {
+    Node &cur{m_nodes[index]};
+    cur.next = before;
+    cur.prev = (before == npos ? m_tail : m_nodes[before].prev);
+
+    if (cur.prev == npos) {
+        m_head = index;
+    } else {
+        m_nodes[cur.prev].next = index;
+    }
+
+    if (before == npos) {
+        m_tail = index;
+    } else {
+        m_nodes[before].prev = index;
+    }
+}
+
+void OrderedList::unlink(quint32 index) {
+    Node &cur{m_nodes[index]};
+
+    if (cur.prev == npos) {
+        m_head = cur.next;
+    } else {
+        m_nodes[cur.prev].next = cur.next;
+    }
+
+    if (cur.next == npos) {
+        m_tail = cur.prev;
+    } else {
+        m_nodes[cur.next].prev = cur.prev;
+    }
+
+    cur.prev = npos;
+    cur.next = npos;
+}
+
+// label for a node placed before the current head
+quint64 OrderedList::frontLabel() {
+    if (m_head == npos) {
+        return midLabel;
+    }
+
+    if (m_nodes[m_head].item->m_orderLabel < labelGap) {
+        relabel();
+    }
+
+    return m_nodes[m_head].item->m_orderLabel - labelGap;
+}
+
+// label for a node placed after the current tail
+quint64 OrderedList::backLabel() {
+    if (m_tail == npos) {
+        return midLabel;
+    }
+
+    if (m_nodes[m_tail].item->m_orderLabel > std::numeric_limits<quint64>::max() - labelGap) {
+        relabel();
+    }
+
+    return m_nodes[m_tail].item->m_orderLabel + labelGap;
+}
+
+// spreads the labels evenly around the middle of the range, handles are
+// limited to 22 bits so this always leaves room at both ends
+void OrderedList::relabel() {
+    quint64 count{0};
+    for (quint32 cur{m_head}; cur != npos; cur = m_nodes[cur].next) {
+        count++;
+    }
+
+    quint64 label{midLabel - (count / 2) * labelGap};
+    for (quint32 cur{m_head}; cur != npos; cur = m_nodes[cur].next) {
+        m_nodes[cur].item->m_orderLabel = label;
+        label += labelGap;
     }
-    if (m_zIndex.find(item) == m_zIndex.end()) {
+}
+
+bool OrderedList::hasItem(const ItemPtr& item) const {
+    quint32 index{item->handle().index()};
+    if (index >= m_nodes.size()) {
         return false;
     }
-    return true;
+
+    // the node keeps the item alive, so its slot can not be handed to another item
+    return m_nodes[index].item == item;
 }
 
 void OrderedList::insert(const ItemPtr& item) {
@@ -41,15 +127,24 @@ void OrderedList::insert(const ItemPtr& item) {
         return;
     }
 
-    int zIndex{0};
-    if (!m_itemList.empty()) {
-        zIndex = m_zIndex[m_itemList.back()] + 1;
+    // Grouping leaves the children in the list right below the group, that
+    // is where ungrouping puts them back. Groups that were not built here,
+    // e.g. loaded ones, get their children placed the same way.
+    if (item->type() == Item::Group) {
+        for (const ItemPtr& child : std::static_pointer_cast<GroupItem>(item)->items()) {
+            insert(child);
+        }
     }
 
-    qDebug() << "Inserting item with index: " << zIndex;
-    m_zIndex[item] = zIndex;
-    m_itemList.push_back(item);
-    m_itemIterMap[item] = std::prev(m_itemList.end());
+    quint32 index{item->handle().index()};
+    if (index >= m_nodes.size()) {
+        m_nodes.resize(std::max<std::size_t>(index + 1, ItemRegistry::instance().capacity()));
+    }
+
+    item->m_orderLabel = backLabel();
+
+    m_nodes[index].item = item;
+    link(index, npos);
 }
 
 void OrderedList::remove(const ItemPtr& item) {
@@ -59,86 +154,91 @@ void OrderedList::remove(const ItemPtr& item) {
     }
 
     qDebug() << "Erasing item from list";
-    m_itemList.erase(m_itemIterMap[item]);
-    m_itemIterMap.erase(item);
-    m_zIndex.erase(item);
+    quint32 index{item->handle().index()};
+    unlink(index);
+    m_nodes[index] = Node{};
+}
+
+void OrderedList::clear() {
+    m_nodes.clear();
+    m_head = npos;
+    m_tail = npos;
 }
 
 void OrderedList::bringForward(const ItemPtr& item) {
     if (!hasItem(item)) {
-        throw std::runtime_error("Item was not found in the iterator map");
+        throw std::runtime_error("Item was not found in the ordered list");
     }
 
-    auto iterator = m_itemIterMap[item];
+    quint32 index{item->handle().index()};
+    quint32 nextIndex{m_nodes[index].next};
 
     // if this is the last element, no need to bring it to the front
-    if (iterator == std::prev(m_itemList.end())) {
+    if (nextIndex == npos) {
         return;
     }
 
     // swap with next
-    auto nextIterator = std::next(iterator);
-    m_itemList.splice(iterator, m_itemList, nextIterator);
+    unlink(nextIndex);
+    link(nextIndex, index);
 
-    int val = m_zIndex[item];
-    m_zIndex[item] = m_zIndex[*nextIterator];
-    m_zIndex[*nextIterator] = val;
+    std::swap(item->m_orderLabel, m_nodes[nextIndex].item->m_orderLabel);
 }
 
 void OrderedList::sendBackward(const ItemPtr& item) {
     if (!hasItem(item)) {
-        throw std::runtime_error("Item was not found in the iterator map");
+        throw std::runtime_error("Item was not found in the ordered list");
     }
 
-    auto iterator = m_itemIterMap[item];
+    quint32 index{item->handle().index()};
+    quint32 prevIndex{m_nodes[index].prev};
 
     // if this is the first element, no need to send it to the back
-    if (iterator == m_itemList.begin()) {
+    if (prevIndex == npos) {
         return;
     }
 
     // swap with previous
-    auto prevIterator = std::prev(iterator);
-    m_itemList.splice(prevIterator, m_itemList, iterator);
+    unlink(index);
+    link(index, prevIndex);
 
-    int val = m_zIndex[item];
-    m_zIndex[item] = m_zIndex[*prevIterator];
-    m_zIndex[*prevIterator] = val;
+    std::swap(item->m_orderLabel, m_nodes[prevIndex].item->m_orderLabel);
 };
 
 void OrderedList::sendToBack(const ItemPtr& item) {
     if (!hasItem(item)) {
-        throw std::runtime_error("Item was not found in the iterator map");
+        throw std::runtime_error("Item was not found in the ordered list");
     }
 
-    auto iterator = m_itemIterMap[item];
-    if (iterator == m_itemList.begin()) {
+    quint32 index{item->handle().index()};
+    if (index == m_head) {
         return;
     }
 
-    auto firstIterator = m_itemList.begin();
-    m_itemList.splice(firstIterator, m_itemList, iterator);
-    m_zIndex[item] = m_zIndex[*firstIterator] - 1;
+    item->m_orderLabel = frontLabel();
+    quint32 firstIndex{m_head};
+    unlink(index);
+    link(index, firstIndex);
 }
 
 void OrderedList::bringToFront(const ItemPtr& item) {
     if (!hasItem(item)) {
-        throw std::runtime_error("Item was not found in the iterator map");
+        throw std::runtime_error("Item was not found in the ordered list");
     }
 
-    auto iterator = m_itemIterMap[item];
-    if (iterator == std::prev(m_itemList.end())) {
+    quint32 index{item->handle().index()};
+    if (index == m_tail) {
         return;
     }
 
-    auto lastIterator = std::prev(m_itemList.end());
-    m_itemList.splice(m_itemList.end(), m_itemList, iterator);
-    m_zIndex[item] = m_zIndex[*lastIterator] + 1;
+    item->m_orderLabel = backLabel();
+    unlink(index);
+    link(index, npos);
 }
 
-int OrderedList::zIndex(const ItemPtr& item) const {
+quint64 OrderedList::zIndex(const ItemPtr& item) const {
     if (!hasItem(item)) {
-        throw std::runtime_error("Item not found in zIndex map");
+        throw std::runtime_error("Item not found in the ordered list");
     }
-    return m_zIndex.at(item);
+    return item->m_orderLabel;
 }
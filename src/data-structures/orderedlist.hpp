@@ -18,26 +18,53 @@
 
 #pragma once
 
-#include <list>
+#include <QtGlobal>
 #include <memory>
-#include <unordered_map>
-class Item;
+#include <vector>
 
-// Keeps track of the z-index of every item
+#include "../item/item.hpp"
+
+/*
+ * Keeps track of the z-index of every item. The list is intrusive and lives in
+ * a contiguous array indexed by the item's handle (see `ItemRegistry`), so
+ * lookups and reorders never hash a pointer.
+ *
+ * The z-order itself is an integer label stored inline in each item. Labels
+ * are spaced `labelGap` apart so moving an item to either end never touches
+ * its neighbours, when an end runs out of room the whole list is relabeled.
+ */
 class OrderedList {
 public:
     using ItemPtr = std::shared_ptr<Item>;
 
 private:
-    std::unordered_map<ItemPtr, std::list<ItemPtr>::iterator> m_itemIterMap;
-    std::list<ItemPtr> m_itemList;
-    std::unordered_map<ItemPtr, int> m_zIndex;
+    static constexpr quint32 npos{0xFFFFFFFF};
+    static constexpr quint64 labelGap{quint64{1} << 32};
+    static constexpr quint64 midLabel{quint64{1} << 63};
+
+    struct Node {
+        ItemPtr item{};
+        quint32 prev{npos};
+        quint32 next{npos};
+    };
+
+    std::vector<Node> m_nodes;
+    quint32 m_head{npos};
+    quint32 m_tail{npos};
+
+    void link(quint32 index, quint32 before);
+    void unlink(quint32 index);
+
+    quint64 frontLabel();
+    quint64 backLabel();
+    void relabel();
 
 public:
     ~OrderedList();
 
     void insert(const ItemPtr& item);
     void remove(const ItemPtr& item);
+    void clear();
 
     void bringForward(const ItemPtr& item);
     void sendBackward(const ItemPtr& item);
@@ -45,5 +72,21 @@ public:
     void bringToFront(const ItemPtr& item);
     bool hasItem(const ItemPtr& item) const;
 
-    int zIndex(const ItemPtr& item) const;
+    quint64 zIndex(const ItemPtr& item) const;
+
+    // the item behind `handle`, empty if it is not in the list
+    const ItemPtr &item(ItemHandle handle) const {
+        static const ItemPtr none{};
+        if (handle.index() >= m_nodes.size()) {
+            return none;
+        }
+
+        const ItemPtr &item{m_nodes[handle.index()].item};
+        return item != nullptr && item->handle() == handle ? item : none;
+    }
+
+    // unchecked comparison for sorting, both items must be in the list
+    static bool isBelow(const ItemPtr& first, const ItemPtr& second) {
+        return first->m_orderLabel < second->m_orderLabel;
+    }
 };
@@ -19,13 +19,17 @@
 #include "quadtree.hpp"
 
 #include <QDebug>
+#include <algorithm>
 #include <cstdlib>
 #include <memory>
 #include <utility>
 
+#include "../common/utils/math.hpp"
 #include "../item/item.hpp"
 #include "orderedlist.hpp"
 
+quint64 QuadTree::queryEpoch = 0;
+
 QuadTree::QuadTree(QRectF region, int capacity) : m_boundingBox{region}, m_capacity{capacity} {
     if (m_orderedList == nullptr) {
         m_orderedList = std::make_shared<OrderedList>();
@@ -67,13 +71,127 @@ void QuadTree::insertItem(const std::shared_ptr<Item>& item, bool updateOrder) {
     insert(item, updateOrder);
 }
 
+// Inserts many items at once, the order of `items` is used as their z-order.
+// The tree is grown to the extent of all items once and the items are handed
+// down it in a single top down pass instead of through repeated insertions.
+// An empty tree is built this way, later batches, e.g. those of a file that
+// is loaded incrementally, are merged into it the same way.
+void QuadTree::bulkLoad(const QVector<ItemPtr>& items) {
+    if (items.empty()) {
+        return;
+    }
+
+    QRectF extent{};
+    for (const ItemPtr &item : items) {
+        extent |= item->boundingBox();
+    }
+
+    expand(extent.topLeft());
+    expand(extent.topRight());
+    expand(extent.bottomRight());
+    expand(extent.bottomLeft());
+
+    for (const ItemPtr &item : items) {
+        m_orderedList->insert(item);
+    }
+
+    // sort along a hilbert curve so every node stores spatially close items
+    // next to each other
+    QVector<std::pair<quint32, ItemPtr>> keyed{};
+    keyed.reserve(items.size());
+    for (const ItemPtr &item : items) {
+        keyed.push_back({Common::Utils::Math::hilbertIndex(extent, item->boundingBox().center()),
+                         item});
+    }
+
+    std::stable_sort(keyed.begin(), keyed.end(), [](const auto &first, const auto &second) {
+        return first.first < second.first;
+    });
+
+    QVector<ItemPtr> sorted{};
+    sorted.reserve(keyed.size());
+    for (auto &[key, item] : keyed) {
+        sorted.push_back(std::move(item));
+    }
+
+    // a cleared tree keeps its empty nodes, they are dropped so it is built
+    // around the new items only
+    if (size() == 0) {
+        m_topLeft.reset();
+        m_topRight.reset();
+        m_bottomRight.reset();
+        m_bottomLeft.reset();
+    }
+
+    build(sorted);
+}
+
+void QuadTree::build(const QVector<ItemPtr>& items) {
+    QVector<ItemPtr> candidates{};
+    candidates.reserve(items.size());
+    for (const ItemPtr &item : items) {
+        if (item->overlaps(m_boundingBox)) {
+            candidates.push_back(item);
+        }
+    }
+
+    if (m_items.size() + candidates.size() <= m_capacity) {
+        for (const ItemPtr &item : candidates) {
+            m_items.push_back(item->handle());
+        }
+        return;
+    }
+
+    // the node is filled up first, just like insert() does, but with items
+    // that would otherwise be copied into several children
+    QPointF center{m_boundingBox.center()};
+    auto straddles = [&](const ItemPtr &item) {
+        const QRectF &box{item->boundingBox()};
+        return (box.left() < center.x() && box.right() > center.x()) ||
+               (box.top() < center.y() && box.bottom() > center.y());
+    };
+
+    QVector<ItemPtr> rest{};
+    rest.reserve(candidates.size());
+    m_items.reserve(m_capacity);
+
+    for (const ItemPtr &item : candidates) {
+        if (m_items.size() < m_capacity && straddles(item)) {
+            m_items.push_back(item->handle());
+        } else {
+            rest.push_back(item);
+        }
+    }
+
+    if (m_items.size() < m_capacity) {
+        qsizetype taken{std::min<qsizetype>(m_capacity - m_items.size(), rest.size())};
+        for (qsizetype i{0}; i < taken; i++) {
+            m_items.push_back(rest[i]->handle());
+        }
+        rest.remove(0, taken);
+    }
+
+    if (rest.empty()) {
+        return;
+    }
+
+    if (m_topLeft == nullptr)
+        subdivide();
+
+    m_topLeft->build(rest);
+    m_topRight->build(rest);
+    m_bottomRight->build(rest);
+    m_bottomLeft->build(rest);
+}
+
 bool QuadTree::insert(const std::shared_ptr<Item>& item, bool updateOrder) {
-    if (!m_boundingBox.intersects(item->boundingBox())) {
+    // long strokes only go to the nodes their chunks reach
+    if (!item->overlaps(m_boundingBox)) {
         return false;
     }
 
     if (m_items.size() < m_capacity) {
-        m_items.push_back(item);
+        m_items.push_back(item->handle());
         
         if (updateOrder)
             m_orderedList->insert(item);
@@ -98,31 +216,39 @@ bool QuadTree::insert(const std::shared_ptr<Item>& item, bool updateOrder) {
     return inserted;
 }
 
+// The item leaves the ordered list even if it is not in the tree, e.g. a
+// removed item whose command left the history.
 void QuadTree::deleteItem(std::shared_ptr<Item> const& item, bool updateOrder) {
+    erase(item);
+
+    if (updateOrder)
+        m_orderedList->remove(item);
+}
+
+void QuadTree::erase(const std::shared_ptr<Item>& item) {
     if (!m_boundingBox.intersects(item->boundingBox())) {
         return;
     }
 
-    auto it = std::find(m_items.begin(), m_items.end(), item);
+    auto it = std::find(m_items.begin(), m_items.end(), item->handle());
     if (it != m_items.end()) {
         m_items.erase(it);
-
-        if (updateOrder)
-            m_orderedList->remove(item);
-
         return;
     }
 
     // If the node is subdivided, attempt to delete the item from children
     if (m_topLeft != nullptr) {
-        m_topLeft->deleteItem(item, updateOrder);
-        m_topRight->deleteItem(item, updateOrder);
-        m_bottomLeft->deleteItem(item, updateOrder);
-        m_bottomRight->deleteItem(item, updateOrder);
+        m_topLeft->erase(item);
+        m_topRight->erase(item);
+        m_bottomLeft->erase(item);
+        m_bottomRight->erase(item);
     }
 }
 
+// The ordered list is cleared as well, it owns the items so this releases
+// them and their handles.
 void QuadTree::clear() {
+    m_orderedList->clear();
     m_items.clear();
 
     if (m_topLeft != nullptr) {
@@ -134,9 +260,7 @@ void QuadTree::clear() {
 }
 
 void QuadTree::reorder(QVector<ItemPtr>& items) const {
-    std::sort(items.begin(), items.end(), [&](auto &firstItem, auto &secondItem) {
-        return m_orderedList->zIndex(firstItem) < m_orderedList->zIndex(secondItem);
-    });
+    std::sort(items.begin(), items.end(), OrderedList::isBelow);
 }
 
 void QuadTree::updateItem(const std::shared_ptr<Item>& item, const QRectF &oldBoundingBox) {
@@ -155,15 +279,15 @@ void QuadTree::update(const std::shared_ptr<Item>& item, const QRectF &oldBoundi
     }
 
     if (m_boundingBox.intersects(oldBoundingBox)) {
-        auto it = std::find(m_items.begin(), m_items.end(), item);
+        auto it = std::find(m_items.begin(), m_items.end(), item->handle());
         if (it != m_items.end()) {
             m_items.erase(it);
         }
     }
 
-    if (!inserted && m_boundingBox.intersects(item->boundingBox())) {
+    if (!inserted && item->overlaps(m_boundingBox)) {
         if (m_items.size() < m_capacity) {
-            m_items.push_back(item);
+            m_items.push_back(item->handle());
             inserted = true;
         } else if (m_topLeft == nullptr)
             subdivide();
@@ -178,28 +302,27 @@ void QuadTree::update(const std::shared_ptr<Item>& item, const QRectF &oldBoundi
 }
 
 void QuadTree::deleteItems(const QRectF &boundingBox) {
-    if (!m_boundingBox.intersects(boundingBox))
-        return;
-
-    for (int i = 0; i < m_items.size();) {
-        if (boundingBox.intersects(m_items[i]->boundingBox())) {
-            m_items.erase(m_items.begin() + i);
-            m_orderedList->remove(m_items[i]);
-        } else {
-            i++;
-        }
-    }
+    // the items are collected first, once an item leaves the ordered list the
+    // handles other nodes hold for it no longer resolve
+    QVector<ItemPtr> items{queryItems(boundingBox, [](const ItemPtr &, const QRectF &) {
+        return true;
+    })};
 
-    if (m_topLeft != nullptr) {
-        m_topLeft->deleteItems(boundingBox);
-        m_topRight->deleteItems(boundingBox);
-        m_bottomRight->deleteItems(boundingBox);
-        m_bottomLeft->deleteItems(boundingBox);
+    for (const ItemPtr &item : items) {
+        deleteItem(item);
     }
 }
 
 QVector<std::shared_ptr<Item>> QuadTree::getAllItems() const {
-    QVector<std::shared_ptr<Item>> curItems{m_items};
+    QVector<std::shared_ptr<Item>> curItems{};
+    curItems.reserve(m_items.size());
+    for (ItemHandle handle : m_items) {
+        const ItemPtr &item{m_orderedList->item(handle)};
+        if (item != nullptr) {
+            curItems.push_back(item);
+        }
+    }
+
     if (m_topLeft != nullptr) {
         curItems += m_topLeft->getAllItems();
         curItems += m_topRight->getAllItems();
@@ -22,7 +22,6 @@
 #include <QRectF>
 #include <QVector>
 #include <memory>
-#include <unordered_map>
 
 #include "../item/item.hpp"
 
@@ -37,13 +36,15 @@ class OrderedList;
 /*
  * NOTE: This is tightly coupled with the OrderedList data structure present in
  * the same directory and the Item class present in the `item` directory.
+ * Nodes only store item handles, every item in the tree is also in the
+ * ordered list which owns it and resolves its handle.
  */
 class QuadTree {
 public:
     using ItemPtr = std::shared_ptr<Item>;
 
 private:
-    QVector<ItemPtr> m_items{};
+    QVector<ItemHandle> m_items{};
     QRectF m_boundingBox{};
     int m_capacity{};
     std::unique_ptr<QuadTree> m_topLeft{nullptr};
@@ -52,6 +53,9 @@ private:
     std::unique_ptr<QuadTree> m_bottomLeft{nullptr};
     std::shared_ptr<OrderedList> m_orderedList{nullptr};
 
+    // incremented by every query, see Item::m_queryEpoch
+    static quint64 queryEpoch;
+
 public:
     QuadTree(QRectF region, int capacity);
     QuadTree(QRectF region, int capacity, std::shared_ptr<OrderedList> orderedList);
@@ -60,6 +64,7 @@ public:
 
     int size() const;
     void insertItem(const ItemPtr& item, bool updateOrder = true);
+    void bulkLoad(const QVector<ItemPtr>& items);
     void deleteItem(const ItemPtr& item, bool updateOrder = true);
     void updateItem(const ItemPtr& item, const QRectF &oldBoundingBox);
     void deleteItems(const QRectF &boundingBox);
@@ -80,13 +85,15 @@ public:
 
 private:
     bool insert(const ItemPtr& item, bool updateOrder);
+    void erase(const ItemPtr& item);
+    void build(const QVector<ItemPtr>& items);
     void update(const ItemPtr& item, const QRectF &oldBoundingBox, bool inserted);
 
     template <typename Shape, typename QueryCondition>
     void query(const Shape &shape,
                QueryCondition condition,
                QVector<ItemPtr> &out,
-               std::unordered_map<ItemPtr, bool> &itemAlreadyPushed) const;
+               quint64 epoch) const;
 
     void subdivide();
     void expand(const QPointF &point);
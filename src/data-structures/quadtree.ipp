@@ -16,12 +16,12 @@
 * along with this program. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "../common/profiler.hpp"
 #include "../common/utils/math.hpp"
 #include "../item/item.hpp"
 #include "orderedlist.hpp"
 #include <cstdlib>
 #include <memory>
-#include <unordered_map>
 
 template <typename Shape>
 QVector<std::shared_ptr<Item>> QuadTree::queryItems(const Shape &shape) const {
@@ -33,16 +33,14 @@ QVector<std::shared_ptr<Item>> QuadTree::queryItems(const Shape &shape) const {
 template <typename Shape, typename QueryCondition>
 QVector<std::shared_ptr<Item>> QuadTree::queryItems(const Shape &shape,
                                                     QueryCondition condition) const {
+    ScopedTimer timer{"QuadTree::queryItems"};
     QVector<std::shared_ptr<Item>> curItems{};
-    std::unordered_map<std::shared_ptr<Item>, bool> itemAlreadyPushed{};
 
     // look for matches and store the result in curItems
-    query(shape, condition, curItems, itemAlreadyPushed);
+    query(shape, condition, curItems, ++QuadTree::queryEpoch);
 
     // sort based on z-index
-    std::sort(curItems.begin(), curItems.end(), [&](auto &firstItem, auto &secondItem) {
-        return m_orderedList->zIndex(firstItem) < m_orderedList->zIndex(secondItem);
-    });
+    std::sort(curItems.begin(), curItems.end(), OrderedList::isBelow);
 
     return curItems;
 };
@@ -51,29 +49,35 @@ template <typename Shape, typename QueryCondition>
 void QuadTree::query(const Shape &shape,
                      QueryCondition condition,
                      QVector<std::shared_ptr<Item>> &out,
-                     std::unordered_map<std::shared_ptr<Item>, bool> &itemAlreadyPushed) const {
+                     quint64 epoch) const {
+    Profiler::instance().add(Profiler::QuadTreeNodesVisited);
     if (!Common::Utils::Math::intersects(m_boundingBox, shape)) {
         return;
     }
 
-    for (const std::shared_ptr<Item> &item : m_items) {
+    for (ItemHandle handle : m_items) {
+        const std::shared_ptr<Item> &item{m_orderedList->item(handle)};
+        if (item == nullptr)
+            continue;
+
+        // multiple nodes may have a handle to the same item, the result for an
+        // item is the same in every node so it is only tested once per query
+        if (item->m_queryEpoch == epoch)
+            continue;
+        item->m_queryEpoch = epoch;
+
         if (Common::Utils::Math::intersects(item->boundingBox(), shape)) {
             if (condition(item, shape)) {
-                // using the hash map because multiple nodes may have a pointer to the
-                // same item
-                if (!itemAlreadyPushed[item]) {
-                    out.push_back(item);
-                    itemAlreadyPushed[item] = true;
-                }
+                out.push_back(item);
             }
         }
     }
 
     // if this node has sub-regions
     if (m_topLeft != nullptr) {
-        m_topLeft->query(shape, condition, out, itemAlreadyPushed);
-        m_topRight->query(shape, condition, out, itemAlreadyPushed);
-        m_bottomRight->query(shape, condition, out, itemAlreadyPushed);
-        m_bottomLeft->query(shape, condition, out, itemAlreadyPushed);
+        m_topLeft->query(shape, condition, out, epoch);
+        m_topRight->query(shape, condition, out, epoch);
+        m_bottomRight->query(shape, condition, out, epoch);
+        m_bottomLeft->query(shape, condition, out, epoch);
     }
 }
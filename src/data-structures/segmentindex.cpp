@@ -0,0 +1,88 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "segmentindex.hpp"
+
+#include "../common/utils/math.hpp"
+
+void SegmentIndex::build(const QVector<QPointF> &points, qreal padding) {
+    clear();
+
+    m_segments = std::max<qsizetype>(points.size() - 1, 0);
+    if (m_segments == 0)
+        return;
+
+    QVector<QRectF> leaves{};
+    leaves.reserve((m_segments + leafSize - 1) / leafSize);
+    for (qsizetype first{0}; first < m_segments; first += leafSize) {
+        qsizetype last{std::min(first + leafSize, m_segments)};
+
+        // segments [first, last) use points [first, last]
+        double minX{points[first].x()}, minY{points[first].y()};
+        double maxX{minX}, maxY{minY};
+        for (qsizetype index{first + 1}; index <= last; index++) {
+            minX = std::min(minX, points[index].x());
+            minY = std::min(minY, points[index].y());
+            maxX = std::max(maxX, points[index].x());
+            maxY = std::max(maxY, points[index].y());
+        }
+
+        leaves.push_back(
+            QRectF{QPointF{minX, minY}, QPointF{maxX, maxY}}.adjusted(-padding, -padding, padding, padding));
+    }
+    m_levels.push_back(std::move(leaves));
+
+    while (m_levels.back().size() > 1) {
+        const QVector<QRectF> &below{m_levels.back()};
+
+        QVector<QRectF> level{};
+        level.reserve((below.size() + 1) / 2);
+        for (qsizetype index{0}; index < below.size(); index += 2) {
+            level.push_back(index + 1 < below.size() ? below[index].united(below[index + 1])
+                                                     : below[index]);
+        }
+        m_levels.push_back(std::move(level));
+    }
+}
+
+void SegmentIndex::clear() {
+    m_segments = 0;
+    m_levels.clear();
+}
+
+bool SegmentIndex::empty() const {
+    return m_levels.empty();
+}
+
+void SegmentIndex::translate(const QPointF &amount) {
+    for (QVector<QRectF> &level : m_levels) {
+        for (QRectF &box : level) {
+            box.translate(amount);
+        }
+    }
+}
+
+bool SegmentIndex::touches(const QRectF &box, const QRectF &rect) {
+    return box.intersects(rect);
+}
+
+// Math::intersects() only looks for crossed edges, a line can also lie inside
+bool SegmentIndex::touches(const QRectF &box, const QLineF &line) {
+    return box.contains(line.p1()) || box.contains(line.p2()) ||
+           Common::Utils::Math::intersects(box, line);
+}
@@ -0,0 +1,64 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QLineF>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+/*
+ * A bounding volume hierarchy over the segments of a polyline, used to hit
+ * test long strokes without walking every segment.
+ *
+ * Leaves cover `leafSize` consecutive segments. Consecutive points of a
+ * stroke lie close together, so grouping by position in the stroke already
+ * gives tight boxes and the tree can be built bottom up in linear time: every
+ * level holds the unions of pairs of boxes of the level below.
+ */
+class SegmentIndex {
+public:
+    static constexpr qsizetype leafSize{16};
+
+    // `padding` grows every box, e.g. by the stroke width
+    void build(const QVector<QPointF> &points, qreal padding);
+    void clear();
+    bool empty() const;
+    void translate(const QPointF &amount);
+
+    /*
+     * Calls `test(first, last)` for the ranges of segments [first, last) whose
+     * boxes `shape` touches, until it returns true. Segment `i` runs from
+     * point `i` to point `i + 1`.
+     */
+    template <typename Shape, typename Test>
+    bool any(const Shape &shape, Test test) const;
+
+private:
+    static bool touches(const QRectF &box, const QRectF &rect);
+    static bool touches(const QRectF &box, const QLineF &line);
+
+    template <typename Shape, typename Test>
+    bool any(const Shape &shape, Test &test, qsizetype level, qsizetype index) const;
+
+    qsizetype m_segments{0};
+    QVector<QVector<QRectF>> m_levels{};  // leaves first, the root is last
+};
+
+#include "segmentindex.ipp"
@@ -0,0 +1,41 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+template <typename Shape, typename Test>
+bool SegmentIndex::any(const Shape &shape, Test test) const {
+    if (m_levels.empty())
+        return false;
+
+    return any(shape, test, m_levels.size() - 1, 0);
+}
+
+template <typename Shape, typename Test>
+bool SegmentIndex::any(const Shape &shape, Test &test, qsizetype level, qsizetype index) const {
+    const QVector<QRectF> &boxes{m_levels[level]};
+    if (index >= boxes.size() || !touches(boxes[index], shape))
+        return false;
+
+    if (level == 0) {
+        qsizetype first{index * leafSize};
+        return test(first, std::min(first + leafSize, m_segments));
+    }
+
+    return any(shape, test, level - 1, 2 * index) || any(shape, test, level - 1, 2 * index + 1);
+}
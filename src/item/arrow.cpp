@@ -18,7 +18,7 @@
 
 #include "arrow.hpp"
 
-#include "../common/utils/math.hpp"
+#include "../common/utils/segments.hpp"
 
 ArrowItem::ArrowItem() {
 }
@@ -50,40 +50,28 @@ void ArrowItem::calcArrowPoints() {
 }
 
 void ArrowItem::m_draw(QPainter &painter, const QPointF &offset) const {
-    painter.drawLine(start() - offset, end() - offset);
-    painter.drawLine(end() - offset, m_arrowP1 - offset);
-    painter.drawLine(end() - offset, m_arrowP2 - offset);
+    // the head is computed when the arrow changes, drawing is a single call
+    QLineF lines[]{QLineF{start(), end()}.translated(-offset),
+                   QLineF{end(), m_arrowP1}.translated(-offset),
+                   QLineF{end(), m_arrowP2}.translated(-offset)};
+    painter.drawLines(lines, 3);
 }
 
 bool ArrowItem::intersects(const QRectF &rect) {
     if (!boundingBox().intersects(rect))
         return false;
 
-    // TODO: Use better techniques to detect collision
-    QPointF p{start()}, q{end()}, r{m_arrowP1}, s{m_arrowP2};
-    QPointF a{rect.x(), rect.y()};
-    QPointF b{rect.x() + rect.width(), rect.y()};
-    QPointF c{rect.x() + rect.width(), rect.y() + rect.height()};
-    QPointF d{rect.x(), rect.y() + rect.height()};
-
-    return (Common::Utils::Math::intersects(QLineF{p, q}, QLineF{a, b}) ||
-            Common::Utils::Math::intersects(QLineF{p, q}, QLineF{b, c}) ||
-            Common::Utils::Math::intersects(QLineF{p, q}, QLineF{c, d}) ||
-            Common::Utils::Math::intersects(QLineF{p, q}, QLineF{d, a}) ||
-            Common::Utils::Math::intersects(QLineF{q, r}, QLineF{a, b}) ||
-            Common::Utils::Math::intersects(QLineF{q, r}, QLineF{b, c}) ||
-            Common::Utils::Math::intersects(QLineF{q, r}, QLineF{c, d}) ||
-            Common::Utils::Math::intersects(QLineF{q, r}, QLineF{d, a}) ||
-            Common::Utils::Math::intersects(QLineF{q, s}, QLineF{a, b}) ||
-            Common::Utils::Math::intersects(QLineF{q, s}, QLineF{b, c}) ||
-            Common::Utils::Math::intersects(QLineF{q, s}, QLineF{c, d}) ||
-            Common::Utils::Math::intersects(QLineF{q, s}, QLineF{d, a}));
+    return Common::Utils::Segments::intersects(outline().data(), outlineSize, rect);
 };
 
 bool ArrowItem::intersects(const QLineF &line) {
-    return (Common::Utils::Math::intersects(QLineF{start(), end()}, line) ||
-            Common::Utils::Math::intersects(QLineF{end(), m_arrowP1}, line) ||
-            Common::Utils::Math::intersects(QLineF{end(), m_arrowP2}, line));
+    return Common::Utils::Segments::intersects(outline().data(), outlineSize, line);
+}
+
+std::array<QPointF, ArrowItem::outlineSize> ArrowItem::outline() const {
+    // the shaft and both sides of the head as one polyline, going back to
+    // the tip once costs a segment but saves a second call
+    return {start(), end(), m_arrowP1, end(), m_arrowP2};
 }
 
 void ArrowItem::translate(const QPointF &amount) {
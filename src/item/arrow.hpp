@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "polygon.hpp"
 
 class ArrowItem : public PolygonItem {
@@ -44,5 +46,8 @@ private:
 
     int m_maxArrowSize{15};  // hardcoded for now
 
+    static constexpr qsizetype outlineSize{5};
+
     void calcArrowPoints();
+    std::array<QPointF, outlineSize> outline() const;
 };
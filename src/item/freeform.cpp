@@ -19,10 +19,16 @@
 #include "freeform.hpp"
 
 #include <QDateTime>
+#include <algorithm>
+#include <QMutexLocker>
+#include <array>
+#include <cmath>
 #include <memory>
+#include <numeric>
+#include <utility>
 
 #include "../common/constants.hpp"
-#include "../common/utils/math.hpp"
+#include "../common/utils/segments.hpp"
 
 FreeformItem::FreeformItem() {
     m_properties[Property::StrokeWidth] = Property{1, Property::StrokeWidth};
@@ -59,6 +65,133 @@ void FreeformItem::addPoint(const QPointF &point, const qreal pressure, bool opt
 
     m_points.push_back(newPoint);
     m_pressures.push_back(pressure);
+    m_segmentIndex.clear();
+    extendChunks(m_chunks, m_points, m_points.size() - 1, mg);
+    extendRuns(m_runs, m_pressures, m_points.size() - 1);
+    clearLods();
+}
+
+// Replaces all points at once, they are taken as is without smoothing
+void FreeformItem::setPoints(QVector<QPointF> points, QVector<qreal> pressures) {
+    m_points = std::move(points);
+    m_pressures = std::move(pressures);
+    m_pressures.resize(m_points.size(), 1.0);
+    m_segmentIndex.clear();
+
+    int mg{property(Property::StrokeWidth).value<int>()};
+    m_chunks.clear();
+    m_runs.clear();
+    for (qsizetype index{0}; index < m_points.size(); index++) {
+        extendChunks(m_chunks, m_points, index, mg);
+        extendRuns(m_runs, m_pressures, index);
+    }
+    clearLods();
+
+    if (m_points.empty()) {
+        m_boundingBox = {};
+        return;
+    }
+
+    double minX{m_points.front().x()}, minY{m_points.front().y()};
+    double maxX{minX}, maxY{minY};
+    for (const QPointF &point : m_points) {
+        minX = std::min(minX, point.x());
+        minY = std::min(minY, point.y());
+        maxX = std::max(maxX, point.x());
+        maxY = std::max(maxY, point.y());
+    }
+
+    m_boundingBox.setTopLeft({minX - mg, minY - mg});
+    m_boundingBox.setBottomRight({maxX + mg, maxY + mg});
+}
+
+// Ramer-Douglas-Peucker: a point is kept if it lies further than `tolerance`
+// from the segment between the points kept around it. Pressure is treated as
+// a third coordinate scaled to the half width it gives the stroke, so points
+// where the width visibly changes are kept as well.
+void FreeformItem::simplify(qreal tolerance) {
+    if (m_points.size() <= 2 || tolerance <= 0)
+        return;
+
+    QVector<QPointF> points{};
+    QVector<qreal> pressures{};
+    for (qsizetype index : simplifiedIndices(tolerance)) {
+        points.push_back(m_points[index]);
+        pressures.push_back(m_pressures[index]);
+    }
+
+    setPoints(std::move(points), std::move(pressures));
+}
+
+// the indices of the points simplify() keeps, in order
+QVector<qsizetype> FreeformItem::simplifiedIndices(qreal tolerance) const {
+    qsizetype count{m_points.size()};
+    if (count <= 2) {
+        QVector<qsizetype> all(count);
+        std::iota(all.begin(), all.end(), 0);
+        return all;
+    }
+
+    qreal pressureScale{property(Property::StrokeWidth).value<qreal>() / 2};
+    auto coords = [&](qsizetype index) -> std::array<qreal, 3> {
+        return {m_points[index].x(), m_points[index].y(), m_pressures[index] * pressureScale};
+    };
+
+    // squared distance of `index` from the segment between `first` and `last`
+    auto distance = [&](qsizetype index, qsizetype first, qsizetype last) {
+        std::array<qreal, 3> p{coords(index)}, a{coords(first)}, b{coords(last)};
+        std::array<qreal, 3> ab{}, ap{};
+        qreal lengthSquared{0}, projection{0};
+        for (int axis{0}; axis < 3; axis++) {
+            ab[axis] = b[axis] - a[axis];
+            ap[axis] = p[axis] - a[axis];
+            lengthSquared += ab[axis] * ab[axis];
+            projection += ab[axis] * ap[axis];
+        }
+
+        qreal t{lengthSquared > 0 ? std::clamp(projection / lengthSquared, 0.0, 1.0) : 0.0};
+        qreal result{0};
+        for (int axis{0}; axis < 3; axis++) {
+            qreal delta{ap[axis] - t * ab[axis]};
+            result += delta * delta;
+        }
+        return result;
+    };
+
+    QVector<bool> keep(count, false);
+    keep.front() = true;
+    keep.back() = true;
+
+    // a stack instead of recursion, strokes can have many thousand points
+    QVector<std::pair<qsizetype, qsizetype>> ranges{{0, count - 1}};
+    while (!ranges.empty()) {
+        auto [first, last]{ranges.takeLast()};
+
+        qreal maxDistance{0};
+        qsizetype farthest{-1};
+        for (qsizetype index{first + 1}; index < last; index++) {
+            qreal cur{distance(index, first, last)};
+            if (cur > maxDistance) {
+                maxDistance = cur;
+                farthest = index;
+            }
+        }
+
+        if (farthest < 0 || maxDistance <= tolerance * tolerance)
+            continue;
+
+        keep[farthest] = true;
+        ranges.push_back({first, farthest});
+        ranges.push_back({farthest, last});
+    }
+
+    QVector<qsizetype> indices{};
+    for (qsizetype index{0}; index < count; index++) {
+        if (keep[index])
+            indices.push_back(index);
+    }
+
+    return indices;
 }
 
 bool FreeformItem::intersects(const QRectF &rect) {
@@ -70,33 +203,93 @@ bool FreeformItem::intersects(const QRectF &rect) {
         return rect.contains(m_points[0]);
     }
 
-    QPointF p{rect.topLeft()};
-    QPointF q{rect.topRight()};
-    QPointF r{rect.bottomRight()};
-    QPointF s{rect.bottomLeft()};
+    // the leaves hold points first to last, tested together by the kernel
+    return segmentIndex().any(rect, [&](qsizetype first, qsizetype last) {
+        return Common::Utils::Segments::intersects(m_points.constData() + first, last - first + 1,
+                                                   rect);
+    });
+}
 
-    for (qsizetype idx{0}; idx < pointsSize - 1; idx++) {
-        QLine l{m_points[idx].toPoint(), m_points[idx + 1].toPoint()};
+bool FreeformItem::intersects(const QLineF &line) {
+    return segmentIndex().any(line, [&](qsizetype first, qsizetype last) {
+        return Common::Utils::Segments::intersects(m_points.constData() + first, last - first + 1,
+                                                   line);
+    });
+}
 
-        if (Common::Utils::Math::intersects(l, QLineF{p, q}) ||
-            Common::Utils::Math::intersects(l, QLineF{q, r}) ||
-            Common::Utils::Math::intersects(l, QLineF{r, s}) ||
-            Common::Utils::Math::intersects(l, QLineF{s, q}) ||
-            rect.contains(m_points[idx].toPoint()) || rect.contains(m_points[idx + 1].toPoint()))
-            return true;
+const SegmentIndex &FreeformItem::segmentIndex() {
+    if (m_segmentIndex.empty()) {
+        // the boxes only have to contain the segments, the padding keeps
+        // boxes of straight horizontal or vertical runs from being empty
+        m_segmentIndex.build(m_points, 1);
     }
 
-    return false;
+    return m_segmentIndex;
 }
 
-bool FreeformItem::intersects(const QLineF &line) {
-    qsizetype pointSize{m_points.size()};
-    for (qsizetype index{1}; index < pointSize; index++) {
-        if (Common::Utils::Math::intersects(QLineF{m_points[index - 1], m_points[index]}, line)) {
-            return true;
+bool FreeformItem::overlaps(const QRectF &region) const {
+    if (!boundingBox().intersects(region))
+        return false;
+
+    int mg{boundingBoxPadding()};
+    return std::any_of(m_chunks.begin(), m_chunks.end(), [&](const Chunk &chunk) {
+        return chunk.box.adjusted(-mg, -mg, mg, mg).intersects(region);
+    });
+}
+
+// Adds point `index` to the last chunk, or starts a new one when it is full.
+// `margin` covers the pen around the points.
+void FreeformItem::extendChunks(QVector<Chunk> &chunks,
+                                const QVector<QPointF> &points,
+                                qsizetype index,
+                                qreal margin) {
+    const QPointF &point{points[index]};
+    QRectF pointBox{point - QPointF{margin, margin}, point + QPointF{margin, margin}};
+
+    if (chunks.empty() || chunks.back().last - chunks.back().first >= chunkSize) {
+        Chunk chunk{std::max<qsizetype>(index - 1, 0), index, pointBox};
+        if (chunk.first < index) {
+            const QPointF &previous{points[chunk.first]};
+            chunk.box |= QRectF{previous - QPointF{margin, margin}, previous + QPointF{margin, margin}};
+        }
+
+        chunks.push_back(chunk);
+        return;
+    }
+
+    Chunk &chunk{chunks.back()};
+    chunk.last = index;
+    chunk.box |= pointBox;
+}
+
+// Chunks that overlap the area the painter draws to, neighbouring ones are
+// merged so they are drawn as one run
+QVector<FreeformItem::Chunk> FreeformItem::visibleChunks(const QVector<Chunk> &chunks,
+                                                         const QPainter &painter,
+                                                         const QPointF &offset) {
+    QRectF visible{};
+    if (painter.device() != nullptr) {
+        QRectF deviceRect{0,
+                          0,
+                          static_cast<qreal>(painter.device()->width()),
+                          static_cast<qreal>(painter.device()->height())};
+        visible = painter.worldTransform().inverted().mapRect(deviceRect).translated(offset);
+    }
+
+    QVector<Chunk> out{};
+    for (const Chunk &chunk : chunks) {
+        if (visible.isValid() && !chunk.box.intersects(visible))
+            continue;
+
+        if (!out.empty() && out.back().last == chunk.first) {
+            out.back().last = chunk.last;
+            out.back().box |= chunk.box;
+        } else {
+            out.push_back(chunk);
         }
     }
-    return false;
+
+    return out;
 }
 
 void FreeformItem::draw(QPainter &painter, const QPointF &offset) {
@@ -157,75 +350,127 @@ void FreeformItem::quickDraw(QPainter &painter, const QPointF &offset) const {
 void FreeformItem::m_draw(QPainter &painter, const QPointF &offset) const {
     int strokeWidth{property(Property::StrokeWidth).value<int>()};
     int alpha{property(Property::Opacity).value<int>()};
-    double currentWidth{strokeWidth * 1.0};
 
     // Intersection points are visible on translucent pressure sensitive strokes
     // So I've disabled the use of pressure senstivity when opacity is not max,
     // for now
     bool canUsePressureSenstivity{alpha == Common::maxItemOpacity};
-    if (!canUsePressureSenstivity) {
-        painter.save();
-        painter.translate(-offset);
-        painter.drawPolyline(m_points);
-        painter.restore();
-        return;
-    }
 
-    qsizetype pointSize{m_points.size()};
-    for (qsizetype index = 0; index < pointSize; index++) {
-        double newWidth{strokeWidth * m_pressures[index]};
+    // Zoomed out, a decimated copy of the stroke looks just the same. It has
+    // chunks of its own, so cells only draw the part of it they show.
+    std::shared_ptr<const Lod> lod{levelOfDetail(painter.worldTransform().m11())};
+    const QVector<QPointF> &points{lod ? lod->points : m_points};
+    const QVector<Run> &runs{lod ? lod->runs : m_runs};
+    QVector<Chunk> chunks{visibleChunks(lod ? lod->chunks : m_chunks, painter, offset)};
 
-        if (abs(newWidth - currentWidth) >= 1e-3) {
+    painter.save();
+    painter.translate(-offset);
+
+    if (m_points.size() == 1) {
+        if (canUsePressureSenstivity) {
             QPen pen{painter.pen()};
-            pen.setWidthF(newWidth);
+            pen.setWidthF(strokeWidth * m_pressures.front());
             painter.setPen(pen);
-
-            currentWidth = newWidth;
         }
 
-        if (index == 0) {
-            painter.drawPoint(m_points.front() - offset);
+        painter.drawPoint(m_points.front());
+    }
+
+    for (const Chunk &chunk : chunks) {
+        if (canUsePressureSenstivity) {
+            drawRuns(painter, points, runs, strokeWidth, chunk.first, chunk.last);
         } else {
-            painter.drawLine(m_points[index - 1] - offset, m_points[index] - offset);
+            painter.drawPolyline(points.constData() + chunk.first,
+                                 static_cast<int>(chunk.last - chunk.first + 1));
         }
     }
-}
 
-qsizetype FreeformItem::size() const {
-    return m_points.size();
+    painter.restore();
 }
 
-int FreeformItem::maxSize() const {
-    // Max number of points per freeform
-    return 500;
-}
+// Adds the segment ending at `index` to the last run, or starts a new run if
+// its (quantized) pressure differs. Segment i - 1 -> i is drawn with the
+// pressure of point i.
+void FreeformItem::extendRuns(QVector<Run> &runs, const QVector<qreal> &pressures, qsizetype index) {
+    if (index == 0)
+        return;
 
-// If the number of points exceeds the limit, this method can be called
-// to split this freeform into multiple smaller freeforms
-QVector<std::shared_ptr<Item>> FreeformItem::split() const {
-    QVector<std::shared_ptr<Item>> items;
+    qreal pressure{std::round(pressures[index] * pressureSteps) / pressureSteps};
+    if (!runs.empty() && runs.back().last == index - 1 && runs.back().pressure == pressure) {
+        runs.back().last = index;
+        return;
+    }
 
-    qsizetype pointSize{m_points.size()};
-    for (qsizetype index = 0; index < pointSize; index++) {
-        if (index % maxSize() == 0) {
-            // add this point to the previous freeform too
-            if (!items.empty()) {
-                std::shared_ptr<FreeformItem> last{
-                    std::static_pointer_cast<FreeformItem>(items.back())};
-                last->addPoint(m_points[index], m_pressures[index]);
-            }
+    runs.push_back(Run{index - 1, index, pressure});
+}
 
-            // create a copy
-            std::shared_ptr<FreeformItem> newItem{std::make_shared<FreeformItem>()};
-            newItem->m_properties = m_properties;
+// Draws the parts of `runs` between points `first` and `last`, one polyline and
+// one pen change per run instead of per segment
+void FreeformItem::drawRuns(QPainter &painter,
+                            const QVector<QPointF> &points,
+                            const QVector<Run> &runs,
+                            qreal strokeWidth,
+                            qsizetype first,
+                            qsizetype last) {
+    auto run{std::lower_bound(runs.begin(), runs.end(), first + 1, [](const Run &run, qsizetype index) {
+        return run.last < index;
+    })};
+
+    QPen pen{painter.pen()};
+    for (; run != runs.end() && run->first < last; run++) {
+        qsizetype from{std::max(run->first, first)};
+        qsizetype to{std::min(run->last, last)};
+
+        pen.setWidthF(strokeWidth * run->pressure);
+        painter.setPen(pen);
+        painter.drawPolyline(points.constData() + from, static_cast<int>(to - from + 1));
+    }
+}
+
+// The decimated copy of the stroke for drawing at `zoomFactor`, null when the
+// stroke should be drawn in full. Copies are made on first use, possibly by
+// several render threads at once.
+std::shared_ptr<const FreeformItem::Lod> FreeformItem::levelOfDetail(qreal zoomFactor) const {
+    if (m_points.size() < minLodPoints)
+        return nullptr;
+
+    // level n is used from a zoom factor of 1 / 2^n on
+    int level{0};
+    while (level < lodLevels && zoomFactor <= 1.0 / (2 << level)) {
+        level++;
+    }
 
-            items.push_back(newItem);
+    if (level == 0)
+        return nullptr;
+
+    QMutexLocker locker{&m_lodMutex};
+    std::shared_ptr<const Lod> &lod{m_lods[level - 1]};
+    if (!lod) {
+        // an error of lodTolerance on screen, in world units
+        qreal tolerance{Common::lodTolerance * (1 << level)};
+        int strokeWidth{property(Property::StrokeWidth).value<int>()};
+
+        auto cur{std::make_shared<Lod>()};
+        for (qsizetype index : simplifiedIndices(tolerance)) {
+            cur->points.push_back(m_points[index]);
+            cur->pressures.push_back(m_pressures[index]);
+            extendRuns(cur->runs, cur->pressures, cur->points.size() - 1);
+            extendChunks(cur->chunks, cur->points, cur->points.size() - 1, strokeWidth);
         }
-        std::shared_ptr<FreeformItem> cur{std::static_pointer_cast<FreeformItem>(items.back())};
-        cur->addPoint(m_points[index], m_pressures[index], false);
+
+        lod = std::move(cur);
     }
 
-    return items;
+    return lod;
+}
+
+void FreeformItem::clearLods() {
+    QMutexLocker locker{&m_lodMutex};
+    m_lods = {};
+}
+
+qsizetype FreeformItem::size() const {
+    return m_points.size();
 }
 
 void FreeformItem::translate(const QPointF &amount) {
@@ -234,6 +479,13 @@ void FreeformItem::translate(const QPointF &amount) {
     }
 
     m_boundingBox.translate(amount);
+    m_segmentIndex.translate(amount);
+
+    for (Chunk &chunk : m_chunks) {
+        chunk.box.translate(amount);
+    }
+
+    clearLods();
 };
 
 Item::Type FreeformItem::type() const {
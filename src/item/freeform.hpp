@@ -18,9 +18,12 @@
 
 #pragma once
 
+#include <QMutex>
+#include <array>
 #include <deque>
 #include <memory>
 
+#include "../data-structures/segmentindex.hpp"
 #include "item.hpp"
 
 class FreeformItem : public Item, public std::enable_shared_from_this<FreeformItem> {
@@ -39,11 +42,15 @@ public:
 
     void translate(const QPointF &amount) override;
 
-    QVector<std::shared_ptr<Item>> split() const;
+    bool overlaps(const QRectF &region) const override;
+
     qsizetype size() const;
-    int maxSize() const;
 
     virtual void addPoint(const QPointF &point, const qreal pressure, bool optimize = true);
+    void setPoints(QVector<QPointF> points, QVector<qreal> pressures);
+
+    // drops the points that change the stroke by less than `tolerance`
+    void simplify(qreal tolerance);
 
     Item::Type type() const override;
 
@@ -56,7 +63,72 @@ protected:
     QVector<qreal> m_pressures{};
 
 private:
+    /*
+     * A run of consecutive points with its bounding box. Strokes of any length
+     * stay a single item, chunks let the quadtree and the renderer skip the
+     * parts of a long stroke that are out of view. Neighbouring chunks share
+     * their boundary point so no segment is lost between them.
+     */
+    struct Chunk {
+        qsizetype first{};  // index of the first point
+        qsizetype last{};   // index of the last point
+        QRectF box{};
+    };
+
+    static constexpr qsizetype chunkSize{256};  // segments per chunk
+
+    // Consecutive segments drawn with the same pen width, as one polyline.
+    // Pressures are rounded to 1 / pressureSteps, too little to be visible.
+    struct Run {
+        qsizetype first{};  // index of the first point
+        qsizetype last{};   // index of the last point
+        qreal pressure{};
+    };
+
+    static constexpr qreal pressureSteps{64};
+
+    // a decimated copy of the stroke for zoomed out views
+    struct Lod {
+        QVector<QPointF> points{};
+        QVector<qreal> pressures{};
+        QVector<Run> runs{};
+        QVector<Chunk> chunks{};
+    };
+
+    static constexpr int lodLevels{3};
+    static constexpr qsizetype minLodPoints{64};  // shorter strokes are always drawn in full
+
+    static void extendRuns(QVector<Run> &runs, const QVector<qreal> &pressures, qsizetype index);
+    static void drawRuns(QPainter &painter,
+                         const QVector<QPointF> &points,
+                         const QVector<Run> &runs,
+                         qreal strokeWidth,
+                         qsizetype first,
+                         qsizetype last);
+
+    std::shared_ptr<const Lod> levelOfDetail(qreal zoomFactor) const;
+    void clearLods();
+    QVector<qsizetype> simplifiedIndices(qreal tolerance) const;
+
     QPointF optimizePoint(const QPointF &newPoint);
+    static void extendChunks(QVector<Chunk> &chunks,
+                             const QVector<QPointF> &points,
+                             qsizetype index,
+                             qreal margin);
+    static QVector<Chunk> visibleChunks(const QVector<Chunk> &chunks,
+                                        const QPainter &painter,
+                                        const QPointF &offset);
+
+    QVector<Chunk> m_chunks{};
+    QVector<Run> m_runs{};
+
+    mutable QMutex m_lodMutex{};
+    mutable std::array<std::shared_ptr<const Lod>, lodLevels> m_lods{};
+
+    // built by the first hit test after the points change
+    const SegmentIndex &segmentIndex();
+    SegmentIndex m_segmentIndex{};
+
     std::deque<QPointF> m_currentWindow;
     QPointF m_currentWindowSum{0, 0};
     int m_bufferSize{7};
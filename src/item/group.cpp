@@ -47,6 +47,10 @@ QVector<std::shared_ptr<Item>> GroupItem::unGroup() {
     return m_items;
 }
 
+const QVector<std::shared_ptr<Item>> &GroupItem::items() const {
+    return m_items;
+}
+
 const QRectF GroupItem::boundingBox() const {
     QRectF result{};
 
@@ -35,6 +35,7 @@ public:
 
     void group(const QVector<std::shared_ptr<Item>>& items);
     QVector<std::shared_ptr<Item>> unGroup();
+    const QVector<std::shared_ptr<Item>> &items() const;
 
     void setProperty(const Property::Type propertyType, Property newObj) override;
     const Property property(const Property::Type propertyType) const override;
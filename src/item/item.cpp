@@ -18,16 +18,49 @@
 
 #include "item.hpp"
 
+#include <algorithm>
 #include <utility>
 
 #include "../common/constants.hpp"
 
+quint64 Item::m_nextUid{1};
+
 // PUBLIC
-Item::Item() {
+Item::Item() : m_handle{ItemRegistry::instance().acquire(this)}, m_uid{m_nextUid++} {
+}
+
+// copies get their own handle and uid
+Item::Item(const Item &other)
+    : m_boundingBox{other.m_boundingBox},
+      m_properties{other.m_properties},
+      m_handle{ItemRegistry::instance().acquire(this)},
+      m_uid{m_nextUid++} {
 }
 
 Item::~Item() {
     qDebug() << "Item deleted: " << m_boundingBox;
+    ItemRegistry::instance().release(m_handle);
+}
+
+ItemHandle Item::handle() const {
+    return m_handle;
+}
+
+quint64 Item::uid() const {
+    return m_uid;
+}
+
+void Item::setUid(quint64 uid) {
+    m_uid = uid;
+    reserveUids(uid + 1);
+}
+
+quint64 Item::nextUid() {
+    return m_nextUid;
+}
+
+void Item::reserveUids(quint64 next) {
+    m_nextUid = std::max(m_nextUid, next);
 }
 
 const QRectF Item::boundingBox() const {
@@ -74,6 +107,10 @@ void Item::setProperty(const Property::Type propertyType, Property newObj) {
 void Item::updateAfterProperty() {}
 void Item::erase(QPainter &painter, const QPointF &offset) const {}
 
+bool Item::overlaps(const QRectF &region) const {
+    return boundingBox().intersects(region);
+}
+
 int Item::boundingBoxPadding() const {
     return Common::boundingBoxPadding;
 }
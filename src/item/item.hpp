@@ -21,13 +21,28 @@
 #include <QPainter>
 #include <QRect>
 
+#include "../data-structures/itemregistry.hpp"
 #include "../properties/property.hpp"
 
 class Item {
 public:
     Item();
+    Item(const Item &other);
     virtual ~Item();
 
+    Item &operator=(const Item &) = delete;
+
+    ItemHandle handle() const;
+
+    // identifies the item in a saved document and its journal, unlike the
+    // handle it is kept across sessions
+    quint64 uid() const;
+    void setUid(quint64 uid);
+
+    // the uid the next item gets, loading a document reserves the uids it uses
+    static quint64 nextUid();
+    static void reserveUids(quint64 next);
+
     virtual bool intersects(const QRectF &rect) = 0;
     virtual bool intersects(const QLineF &rect) = 0;
 
@@ -38,6 +53,10 @@ public:
 
     virtual const QRectF boundingBox() const;
 
+    // whether the item may cover part of `region`, items that are spread out
+    // (e.g. long strokes) answer more precisely than their bounding box
+    virtual bool overlaps(const QRectF &region) const;
+
     int boundingBoxPadding() const;
 
     virtual void setProperty(const Property::Type propertyType, Property newObj);
@@ -56,4 +75,20 @@ protected:
     std::unordered_map<Property::Type, Property> m_properties{};
 
     virtual void m_draw(QPainter &painter, const QPointF &offset) const = 0;
+
+private:
+    ItemHandle m_handle{};
+    quint64 m_uid{};
+
+    static quint64 m_nextUid;
+
+    // epoch of the last QuadTree query that visited this item, lets the query
+    // skip items stored in multiple nodes without building a hash set
+    quint64 m_queryEpoch{0};
+
+    // position in the OrderedList, a higher label is drawn on top
+    quint64 m_orderLabel{0};
+
+    friend class QuadTree;
+    friend class OrderedList;
 };
@@ -56,6 +56,10 @@ void TextItem::createTextBox(const QPointF position) {
     m_boundingBox.setHeight(metrics.height());
 }
 
+QPointF TextItem::position() const {
+    return m_boundingBox.topLeft();
+}
+
 bool TextItem::intersects(const QRectF &rect) {
     return m_boundingBox.intersects(rect);
 }
@@ -37,6 +37,10 @@ public:
 
     void createTextBox(const QPointF position);
 
+    // the top left corner passed to createTextBox(), without the padding of
+    // boundingBox()
+    QPointF position() const;
+
     enum Mode { EDIT, NORMAL };
 
     Mode mode() const;
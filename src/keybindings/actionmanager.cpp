@@ -18,6 +18,8 @@
 
 #include "actionmanager.hpp"
 
+#include <QDir>
+#include <QFileDialog>
 #include <memory>
 
 #include "../command/commandhistory.hpp"
@@ -29,6 +31,7 @@
 #include "../command/selectcommand.hpp"
 #include "../command/ungroupcommand.hpp"
 #include "../components/propertybar.hpp"
+#include "../common/profiler.hpp"
 #include "../components/toolbar.hpp"
 #include "../context/applicationcontext.hpp"
 #include "../context/coordinatetransformer.hpp"
@@ -39,6 +42,7 @@
 #include "../data-structures/cachegrid.hpp"
 #include "../data-structures/quadtree.hpp"
 #include "../serializer/loader.hpp"
+#include "../serializer/loadjob.hpp"
 #include "../serializer/serializer.hpp"
 #include "action.hpp"
 #include "keybindmanager.hpp"
@@ -131,11 +135,26 @@ ActionManager::ActionManager(ApplicationContext *context) : m_context{context},
                                     [&, context]() { this->saveToFile(); },
                                     context}};
 
+    Action *exportArchiveAction{new Action{"Export Archive",
+                                           "Export a densely compressed copy of the canvas",
+                                           [&, context]() { this->exportArchive(); },
+                                           context}};
+
     Action *openFileAction{new Action{"Open File",
                                       "Open an existing file",
                                       [&, context]() { this->loadFromFile(); },
                                       context}};
 
+    Action *performanceOverlayAction{new Action{"Performance Overlay",
+                                                "Show frame times and render counters",
+                                                [&]() { this->togglePerformanceOverlay(); },
+                                                context}};
+
+    Action *traceAction{new Action{"Record Trace",
+                                   "Start or stop recording a performance trace",
+                                   [&]() { this->toggleTrace(); },
+                                   context}};
+
     keybindManager.addKeybinding(undoAction, "Ctrl+Z");
     keybindManager.addKeybinding(redoAction, "Ctrl+Y");
     keybindManager.addKeybinding(redoAction, "Ctrl+Shift+Z");
@@ -156,8 +175,11 @@ ActionManager::ActionManager(ApplicationContext *context) : m_context{context},
     keybindManager.addKeybinding(saveAction, "Ctrl+S");
     keybindManager.addKeybinding(saveAsAction, "Ctrl+Shift+S");
     keybindManager.addKeybinding(openFileAction, "Ctrl+O");
+    keybindManager.addKeybinding(exportArchiveAction, "Ctrl+Shift+E");
     keybindManager.addKeybinding(groupAction, "Ctrl+G");
     keybindManager.addKeybinding(unGroupAction, "Ctrl+Shift+G");
+    keybindManager.addKeybinding(performanceOverlayAction, "Ctrl+Shift+P");
+    keybindManager.addKeybinding(traceAction, "Ctrl+Shift+T");
 }
 
 void ActionManager::undo() {
@@ -265,7 +287,21 @@ void ActionManager::selectAll() {
     m_context->renderingContext().markForUpdate();
 }
 
+// a half loaded board must not replace a file, the load may still fail and
+// put the previous board back
+bool ActionManager::m_canSave() const {
+    if (LoadJob::isLoading(m_context)) {
+        m_context->uiContext().showNotification("Wait for the file to finish loading");
+        return false;
+    }
+
+    return true;
+}
+
 void ActionManager::saveToFile() {
+    if (!m_canSave())
+        return;
+
     Serializer serializer{};
 
     serializer.serialize(m_context);
@@ -276,8 +312,16 @@ void ActionManager::saveToFile() {
 }
 
 void ActionManager::saveCurrentFile() {
+    if (!m_canSave())
+        return;
+
     // Save to the currently open file, or show Save As dialog if no file is open
     Serializer serializer{};
+    if (serializer.commitJournal(m_context)) {
+        m_context->uiContext().showNotification("File saved successfully!");
+        m_context->uiContext().changesTracker().markSaved();
+        return;
+    }
 
     serializer.serialize(m_context);
     if (serializer.saveCurrentFile()) {
@@ -292,8 +336,48 @@ void ActionManager::saveCurrentFile() {
     }
 }
 
+void ActionManager::exportArchive() {
+    if (!m_canSave())
+        return;
+
+    Serializer serializer{};
+
+    serializer.serialize(m_context);
+    if (serializer.exportArchive()) {
+        m_context->uiContext().showNotification("Archive exported successfully!");
+    }
+}
+
 void ActionManager::loadFromFile() {
     Loader loader{};
     loader.loadFromFile(m_context);
     m_context->uiContext().changesTracker().markSaved();
 }
+
+void ActionManager::togglePerformanceOverlay() {
+    Profiler &profiler{Profiler::instance()};
+    profiler.setOverlayVisible(!profiler.overlayVisible());
+
+    // also clears the overlay once it is hidden
+    m_context->renderingContext().markForUpdate();
+}
+
+void ActionManager::toggleTrace() {
+    Profiler &profiler{Profiler::instance()};
+    if (!profiler.tracing()) {
+        profiler.startTrace();
+        m_context->uiContext().showNotification("Recording trace...");
+        return;
+    }
+
+    profiler.stopTrace();
+
+    QString defaultFilePath{QDir::home().filePath("drawy-trace.json")};
+    QString fileName{QFileDialog::getSaveFileName(
+        nullptr, "Save Trace", defaultFilePath, "Chrome trace (*.json)")};
+
+    if (fileName.isEmpty() || !profiler.saveTrace(fileName))
+        return;
+
+    m_context->uiContext().showNotification("Trace saved successfully!");
+}
@@ -45,8 +45,13 @@ public:
     void ungroupItems();
     void saveToFile();
     void saveCurrentFile();
+    void exportArchive();
     void loadFromFile();
+    void togglePerformanceOverlay();
+    void toggleTrace();
 
 private:
     ApplicationContext *m_context;
+
+    bool m_canSave() const;
 };
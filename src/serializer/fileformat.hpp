@@ -0,0 +1,50 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QDataStream>
+#include <QtGlobal>
+
+/*
+ * Layout of a binary .drawy file:
+ *
+ *   header   "DRWY", quint16 version, quint8 compression, quint64 snapshot
+ *            id (never compressed)
+ *   payload  QPointF offset, double zoom factor, quint32 item count, quint64
+ *            next item uid and then one ItemRecord per item (see itemrecord.hpp)
+ *
+ * The snapshot id changes on every full save and ties the file to its journal
+ * (see journal.hpp). Version 2 files have no snapshot id, no next uid and no
+ * uids in their records.
+ *
+ * A Kanzi payload records its codecs in kanzi's own stream header, so files
+ * written with any compression profile are read the same way.
+ *
+ * Everything is little endian. Files without the magic are legacy JSON files.
+ */
+namespace FileFormat {
+inline constexpr char magic[4]{'D', 'R', 'W', 'Y'};
+inline constexpr quint16 version{3};
+inline constexpr QDataStream::Version streamVersion{QDataStream::Qt_6_0};
+
+enum Compression : quint8 { None, Kanzi };
+
+inline constexpr char journalMagic[4]{'D', 'R', 'W', 'J'};
+inline constexpr quint16 journalVersion{1};
+}  // namespace FileFormat
@@ -0,0 +1,363 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "itemrecord.hpp"
+
+#include <QSysInfo>
+
+#include "../item/arrow.hpp"
+#include "../item/ellipse.hpp"
+#include "../item/freeform.hpp"
+#include "../item/group.hpp"
+#include "../item/line.hpp"
+#include "../item/polygon.hpp"
+#include "../item/rectangle.hpp"
+#include "../item/text.hpp"
+
+static_assert(sizeof(qreal) == sizeof(double), "point arrays are stored as doubles");
+
+namespace {
+// Points and pressures are stored as packed little endian doubles, which is
+// exactly their layout in memory on little endian machines.
+template <typename T>
+void writeArray(QDataStream &stream, const QVector<T> &values) {
+    if constexpr (QSysInfo::ByteOrder == QSysInfo::LittleEndian) {
+        stream.writeRawData(reinterpret_cast<const char *>(values.constData()),
+                            static_cast<int>(values.size() * sizeof(T)));
+    } else {
+        for (const T &value : values) {
+            stream << value;
+        }
+    }
+}
+
+template <typename T>
+void readArray(QDataStream &stream, QVector<T> &values, qsizetype count) {
+    values.resize(count);
+
+    if constexpr (QSysInfo::ByteOrder == QSysInfo::LittleEndian) {
+        qint64 bytes{static_cast<qint64>(count * sizeof(T))};
+        if (stream.readRawData(reinterpret_cast<char *>(values.data()), bytes) != bytes) {
+            stream.setStatus(QDataStream::ReadPastEnd);
+        }
+    } else {
+        for (T &value : values) {
+            stream >> value;
+        }
+    }
+}
+}  // namespace
+
+ItemRecord ItemRecord::fromItem(const Item &item) {
+    ItemRecord record{};
+    record.type = item.type();
+    record.uid = item.uid();
+
+    switch (item.type()) {
+        case Item::Freeform: {
+            const auto &freeform{static_cast<const FreeformItem &>(item)};
+            record.properties = freeform.properties();
+            record.points = freeform.points();
+            record.pressures = freeform.pressures();
+            break;
+        }
+        case Item::Rectangle:
+        case Item::Ellipse:
+        case Item::Arrow:
+        case Item::Line: {
+            const auto &polygon{static_cast<const PolygonItem &>(item)};
+            record.properties = polygon.properties();
+            record.start = polygon.start();
+            record.end = polygon.end();
+            break;
+        }
+        case Item::Text: {
+            const auto &text{static_cast<const TextItem &>(item)};
+            record.properties = text.properties();
+            record.start = text.position();
+            record.text = text.text();
+            break;
+        }
+        case Item::Group: {
+            // the properties of a group are the properties of its children
+            const auto &group{static_cast<const GroupItem &>(item)};
+            for (const auto &child : group.items()) {
+                record.children.push_back(fromItem(*child));
+            }
+            break;
+        }
+    }
+
+    return record;
+}
+
+std::shared_ptr<Item> ItemRecord::toItem() const {
+    std::shared_ptr<Item> item{createItem()};
+    if (uid != 0) {
+        item->setUid(uid);
+    }
+
+    return item;
+}
+
+void ItemRecord::translate(const QPointF &delta) {
+    for (QPointF &point : points) {
+        point += delta;
+    }
+
+    start += delta;
+    end += delta;
+
+    for (ItemRecord &child : children) {
+        child.translate(delta);
+    }
+}
+
+// like the items, only properties the record already has are changed
+void ItemRecord::setProperty(const Property &property) {
+    for (Property &current : properties) {
+        if (current.type() == property.type()) {
+            current = property;
+        }
+    }
+
+    for (ItemRecord &child : children) {
+        child.setProperty(property);
+    }
+}
+
+std::shared_ptr<Item> ItemRecord::createItem() const {
+    std::shared_ptr<Item> item;
+
+    switch (type) {
+        case Item::Freeform: {
+            std::shared_ptr<FreeformItem> cur{std::make_shared<FreeformItem>()};
+
+            // the stroke width has to be known before the bounding box is computed
+            for (const Property &property : properties) {
+                cur->setProperty(property.type(), property);
+            }
+            cur->setPoints(points, pressures);
+
+            return cur;
+        }
+        case Item::Rectangle:
+            item = std::make_shared<RectangleItem>();
+            break;
+        case Item::Ellipse:
+            item = std::make_shared<EllipseItem>();
+            break;
+        case Item::Line:
+            item = std::make_shared<LineItem>();
+            break;
+        case Item::Arrow:
+            item = std::make_shared<ArrowItem>();
+            break;
+        case Item::Text: {
+            std::shared_ptr<TextItem> cur{std::make_shared<TextItem>()};
+            cur->createTextBox(start);
+            cur->insertText(text);
+
+            for (const Property &property : properties) {
+                cur->setProperty(property.type(), property);
+            }
+
+            return cur;
+        }
+        case Item::Group: {
+            std::shared_ptr<GroupItem> cur{std::make_shared<GroupItem>()};
+
+            QVector<std::shared_ptr<Item>> items{};
+            items.reserve(children.size());
+            for (const ItemRecord &child : children) {
+                items.push_back(child.toItem());
+            }
+            cur->group(items);
+
+            return cur;
+        }
+    }
+
+    auto polygon{std::static_pointer_cast<PolygonItem>(item)};
+    for (const Property &property : properties) {
+        polygon->setProperty(property.type(), property);
+    }
+    polygon->setStart(start);
+    polygon->setEnd(end);
+
+    return polygon;
+}
+
+ItemRecordWriter::ItemRecordWriter(QDataStream &stream) : m_stream{stream} {
+}
+
+void ItemRecordWriter::write(const ItemRecord &record) {
+    m_stream << static_cast<quint8>(record.type) << record.uid;
+
+    m_stream << static_cast<quint16>(record.properties.size());
+    for (const Property &property : record.properties) {
+        writeProperty(property);
+    }
+
+    switch (record.type) {
+        case Item::Freeform:
+            m_stream << static_cast<quint32>(record.points.size());
+            writeArray(m_stream, record.points);
+            writeArray(m_stream, record.pressures);
+            break;
+        case Item::Rectangle:
+        case Item::Ellipse:
+        case Item::Arrow:
+        case Item::Line:
+            m_stream << record.start << record.end;
+            break;
+        case Item::Text:
+            m_stream << record.start << record.text;
+            break;
+        case Item::Group:
+            m_stream << static_cast<quint32>(record.children.size());
+            for (const ItemRecord &child : record.children) {
+                write(child);
+            }
+            break;
+    }
+}
+
+void ItemRecordWriter::writeProperty(const Property &property) {
+    QByteArray encoded{};
+    {
+        QDataStream encoder{&encoded, QIODevice::WriteOnly};
+        encoder.setVersion(m_stream.version());
+        encoder.setByteOrder(m_stream.byteOrder());
+        encoder << static_cast<quint8>(property.type()) << property.variant();
+    }
+
+    auto it{m_propertyTable.constFind(encoded)};
+    if (it != m_propertyTable.cend()) {
+        m_stream << it.value();
+        return;
+    }
+
+    // a new entry is announced by its index being the size of the table
+    quint32 index{static_cast<quint32>(m_propertyTable.size())};
+    m_propertyTable.insert(encoded, index);
+
+    m_stream << index;
+    m_stream.writeRawData(encoded.constData(), static_cast<int>(encoded.size()));
+}
+
+ItemRecordReader::ItemRecordReader(QDataStream &stream, quint16 version)
+    : m_stream{stream},
+      m_version{version} {
+}
+
+ItemRecord ItemRecordReader::read() {
+    ItemRecord record{};
+
+    quint8 type{};
+    m_stream >> type;
+    if (type > Item::Group) {
+        m_stream.setStatus(QDataStream::ReadCorruptData);
+        return record;
+    }
+    record.type = static_cast<Item::Type>(type);
+
+    if (m_version >= 3) {
+        m_stream >> record.uid;
+    }
+
+    quint16 propertyCount{};
+    m_stream >> propertyCount;
+    for (quint16 i{0}; i < propertyCount && m_stream.status() == QDataStream::Ok; i++) {
+        record.properties.push_back(readProperty());
+    }
+
+    switch (record.type) {
+        case Item::Freeform: {
+            quint32 count{};
+            m_stream >> count;
+            if (!canRead(count * static_cast<qint64>(sizeof(QPointF) + sizeof(qreal)))) {
+                break;
+            }
+
+            readArray(m_stream, record.points, count);
+            readArray(m_stream, record.pressures, count);
+            break;
+        }
+        case Item::Rectangle:
+        case Item::Ellipse:
+        case Item::Arrow:
+        case Item::Line:
+            m_stream >> record.start >> record.end;
+            break;
+        case Item::Text:
+            m_stream >> record.start >> record.text;
+            break;
+        case Item::Group: {
+            quint32 count{};
+            m_stream >> count;
+            for (quint32 i{0}; i < count && m_stream.status() == QDataStream::Ok; i++) {
+                record.children.push_back(read());
+            }
+            break;
+        }
+    }
+
+    return record;
+}
+
+Property ItemRecordReader::readProperty() {
+    quint32 index{};
+    m_stream >> index;
+
+    if (index < m_propertyTable.size()) {
+        return m_propertyTable[index];
+    }
+
+    if (index != m_propertyTable.size()) {
+        m_stream.setStatus(QDataStream::ReadCorruptData);
+        return {};
+    }
+
+    quint8 type{};
+    QVariant value{};
+    m_stream >> type >> value;
+
+    Property property{value, static_cast<Property::Type>(type)};
+    m_propertyTable.push_back(property);
+    return property;
+}
+
+// guards against allocating huge arrays for corrupt counts, the size of a
+// sequential device (like a decompressor) is unknown so only a sanity limit
+// is checked there
+bool ItemRecordReader::canRead(qint64 bytes) {
+    constexpr qint64 maxSequentialRead{qint64{1} << 30};
+
+    QIODevice *device{m_stream.device()};
+    if (device == nullptr)
+        return true;
+
+    qint64 available{device->isSequential() ? maxSequentialRead : device->bytesAvailable()};
+    if (available < bytes) {
+        m_stream.setStatus(QDataStream::ReadCorruptData);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,102 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QDataStream>
+#include <QHash>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+#include "../item/item.hpp"
+#include "../properties/property.hpp"
+#include "fileformat.hpp"
+
+/*
+ * A plain copy of everything needed to save and recreate an item, this is what
+ * the binary .drawy format stores for every item.
+ */
+struct ItemRecord {
+    Item::Type type{};
+    quint64 uid{};  // 0 for records read from version 2 files
+    QVector<Property> properties{};
+
+    // freeform
+    QVector<QPointF> points{};
+    QVector<qreal> pressures{};
+
+    // polygons, `start` is also the top left corner of text
+    QPointF start{};
+    QPointF end{};
+
+    // text
+    QString text{};
+
+    // group
+    QVector<ItemRecord> children{};
+
+    static ItemRecord fromItem(const Item &item);
+    std::shared_ptr<Item> toItem() const;
+
+    // the record counterparts of Item::translate() and Item::setProperty(),
+    // used when replaying a journal
+    void translate(const QPointF &delta);
+    void setProperty(const Property &property);
+
+private:
+    std::shared_ptr<Item> createItem() const;
+};
+
+/*
+ * Writes records to a stream. Properties are stored in a table that grows as
+ * the records are written: a property is written out the first time it is
+ * used and referenced by its index in the table after that.
+ */
+class ItemRecordWriter {
+public:
+    ItemRecordWriter(QDataStream &stream);
+
+    void write(const ItemRecord &record);
+
+private:
+    void writeProperty(const Property &property);
+
+    QDataStream &m_stream;
+    QHash<QByteArray, quint32> m_propertyTable{};
+};
+
+/*
+ * Reads records written by ItemRecordWriter. Failures are reported through
+ * the status of the stream.
+ */
+class ItemRecordReader {
+public:
+    ItemRecordReader(QDataStream &stream, quint16 version = FileFormat::version);
+
+    ItemRecord read();
+
+private:
+    Property readProperty();
+    bool canRead(qint64 bytes);
+
+    QDataStream &m_stream;
+    quint16 m_version{};
+    QVector<Property> m_propertyTable{};
+};
@@ -0,0 +1,451 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "journal.hpp"
+
+#include <QDataStream>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <algorithm>
+#include <iterator>
+
+#include "../common/constants.hpp"
+#include "../item/item.hpp"
+#include "../properties/property.hpp"
+#include "fileformat.hpp"
+
+namespace {
+constexpr qint64 headerSize{sizeof(FileFormat::journalMagic) + sizeof(quint16) + sizeof(quint64)};
+constexpr quint32 maxEntrySize{1u << 30};
+
+void setupStream(QDataStream &stream) {
+    stream.setVersion(FileFormat::streamVersion);
+    stream.setByteOrder(QDataStream::LittleEndian);
+}
+
+// The children of a group only become records of their own when the group is
+// dissolved, they then sit right below where the group was like they do in
+// OrderedList. Each one gets an order between the group and whatever was below.
+void placeChildren(const ItemRecord &group,
+                   double below,
+                   double order,
+                   QHash<quint64, double> &childOrders) {
+    qsizetype count{group.children.size()};
+    for (qsizetype i{0}; i < count; i++) {
+        double childOrder{below + (order - below) * static_cast<double>(i + 1) / (count + 1)};
+        childOrders.insert(group.children[i].uid, childOrder);
+        placeChildren(group.children[i], below, childOrder, childOrders);
+        below = childOrder;
+    }
+}
+
+bool writeHeader(QIODevice &device, quint64 snapshotId) {
+    QDataStream stream{&device};
+    setupStream(stream);
+
+    stream.writeRawData(FileFormat::journalMagic, sizeof(FileFormat::journalMagic));
+    stream << FileFormat::journalVersion << snapshotId;
+
+    return stream.status() == QDataStream::Ok;
+}
+
+bool readHeader(QIODevice &device, quint64 snapshotId) {
+    QDataStream stream{&device};
+    setupStream(stream);
+
+    char magic[sizeof(FileFormat::journalMagic)]{};
+    quint16 version{};
+    quint64 id{};
+
+    stream.readRawData(magic, sizeof(magic));
+    stream >> version >> id;
+
+    return stream.status() == QDataStream::Ok &&
+           std::equal(std::begin(magic), std::end(magic), std::begin(FileFormat::journalMagic)) &&
+           version <= FileFormat::journalVersion && id == snapshotId;
+}
+
+struct ScanResult {
+    bool valid{false};
+    qint64 end{};        // where the last intact entry ends
+    qint64 committed{};  // where the last Commit entry ends
+};
+
+// reads the journal up to its first damaged entry, the payload of every
+// intact entry is passed to `visit`
+ScanResult scan(QIODevice &device,
+                quint64 snapshotId,
+                const std::function<void(const QByteArray &)> &visit = {}) {
+    ScanResult result{};
+    if (!readHeader(device, snapshotId))
+        return result;
+
+    result.valid = true;
+    result.end = result.committed = device.pos();
+
+    QDataStream stream{&device};
+    setupStream(stream);
+
+    while (true) {
+        quint32 size{};
+        quint16 checksum{};
+        stream >> size >> checksum;
+
+        if (stream.status() != QDataStream::Ok || size == 0 || size > maxEntrySize)
+            break;
+
+        QByteArray payload{device.read(size)};
+        if (payload.size() != size || qChecksum(payload) != checksum)
+            break;
+
+        if (visit)
+            visit(payload);
+
+        result.end = device.pos();
+        if (static_cast<quint8>(payload[0]) == Journal::Commit) {
+            result.committed = result.end;
+        }
+    }
+
+    return result;
+}
+}  // namespace
+
+Journal::Journal() {
+}
+
+Journal::~Journal() {
+    close();
+}
+
+bool Journal::open(const QString &documentPath, quint64 snapshotId) {
+    close();
+
+    m_file.setFileName(filePath(documentPath));
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "[Journal] Failed to open journal:" << m_file.errorString();
+        return false;
+    }
+
+    ScanResult result{scan(m_file, snapshotId)};
+    if (!result.valid) {
+        // left over from an older snapshot of the document
+        m_file.resize(0);
+        m_file.seek(0);
+        if (!writeHeader(m_file, snapshotId) || !m_file.flush()) {
+            qWarning() << "[Journal] Failed to write journal:" << m_file.errorString();
+            m_file.close();
+            return false;
+        }
+
+        result.end = result.committed = headerSize;
+    }
+
+    // drop whatever a crash left after the last intact entry
+    m_file.resize(result.end);
+    m_file.seek(result.end);
+
+    m_documentPath = documentPath;
+    m_snapshotId = snapshotId;
+    m_committedSize = result.committed;
+    m_complete = true;
+    return true;
+}
+
+// entries that were never committed are changes the user did not save
+void Journal::close() {
+    if (!m_file.isOpen())
+        return;
+
+    m_file.resize(m_committedSize);
+    m_file.close();
+
+    m_documentPath.clear();
+    m_snapshotId = 0;
+    m_committedSize = 0;
+}
+
+bool Journal::isOpen() const {
+    return m_file.isOpen();
+}
+
+const QString &Journal::documentPath() const {
+    return m_documentPath;
+}
+
+quint64 Journal::snapshotId() const {
+    return m_snapshotId;
+}
+
+qint64 Journal::size() const {
+    return m_file.isOpen() ? m_file.size() : 0;
+}
+
+bool Journal::needsCompaction() const {
+    qint64 documentSize{QFileInfo{m_documentPath}.size()};
+    return size() - headerSize > documentSize * Common::journalCompactionRatio;
+}
+
+bool Journal::isComplete() const {
+    return m_complete;
+}
+
+void Journal::markIncomplete() {
+    m_complete = false;
+}
+
+void Journal::insert(const Item &item) {
+    append(Insert, item.uid(), [&item](QDataStream &stream) {
+        ItemRecordWriter writer{stream};
+        writer.write(ItemRecord::fromItem(item));
+    });
+}
+
+void Journal::update(const Item &item) {
+    append(Update, item.uid(), [&item](QDataStream &stream) {
+        ItemRecordWriter writer{stream};
+        writer.write(ItemRecord::fromItem(item));
+    });
+}
+
+void Journal::remove(const Item &item) {
+    append(Remove, item.uid());
+}
+
+void Journal::move(const Item &item, const QPointF &delta) {
+    append(Move, item.uid(), [&delta](QDataStream &stream) { stream << delta; });
+}
+
+void Journal::setProperty(const Item &item, const Property &property) {
+    append(SetProperty, item.uid(), [&property](QDataStream &stream) {
+        stream << static_cast<quint8>(property.type()) << property.variant();
+    });
+}
+
+void Journal::view(const QPointF &offsetPos, qreal zoomFactor) {
+    append(View, 0, [&](QDataStream &stream) {
+        stream << offsetPos << static_cast<double>(zoomFactor);
+    });
+}
+
+bool Journal::commit() {
+    if (!append(Commit, 0))
+        return false;
+
+    m_committedSize = m_file.pos();
+    return true;
+}
+
+bool Journal::rebase(quint64 snapshotId, qint64 offset) {
+    if (!m_file.isOpen())
+        return false;
+
+    m_file.seek(offset);
+    QByteArray tail{m_file.readAll()};
+
+    // the tail is committed if a commit was written after the snapshot
+    qint64 committedSize{headerSize + std::max<qint64>(m_committedSize - offset, 0)};
+    QString documentPath{m_documentPath};
+
+    m_file.close();
+
+    QSaveFile journal{filePath(documentPath)};
+    if (!journal.open(QIODevice::WriteOnly) || !writeHeader(journal, snapshotId) ||
+        journal.write(tail) != tail.size() || !journal.commit()) {
+        qWarning() << "[Journal] Failed to rebase journal:" << journal.errorString();
+        m_documentPath.clear();
+        m_snapshotId = 0;
+        m_committedSize = 0;
+        return false;
+    }
+
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        qWarning() << "[Journal] Failed to open journal:" << m_file.errorString();
+        m_documentPath.clear();
+        m_snapshotId = 0;
+        m_committedSize = 0;
+        return false;
+    }
+
+    m_file.seek(m_file.size());
+    m_snapshotId = snapshotId;
+    m_committedSize = committedSize;
+    return true;
+}
+
+QString Journal::filePath(const QString &documentPath) {
+    return documentPath + ".journal";
+}
+
+bool Journal::exists(const QString &documentPath, quint64 snapshotId) {
+    QFile file{filePath(documentPath)};
+    return file.open(QIODevice::ReadOnly) && readHeader(file, snapshotId);
+}
+
+bool Journal::replay(const QString &documentPath,
+                     quint64 snapshotId,
+                     QVector<ItemRecord> &records,
+                     QPointF &offsetPos,
+                     qreal &zoomFactor,
+                     bool &uncommitted) {
+    QFile file{filePath(documentPath)};
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    // removed records keep their slot, undoing a removal puts the item back
+    // where it was, and ungrouped children take the slot of their group
+    QHash<quint64, qsizetype> positions{};
+    QHash<quint64, double> childOrders{};
+    QVector<bool> removed(records.size(), false);
+    QVector<double> orders(records.size());
+    for (qsizetype i{0}; i < records.size(); i++) {
+        positions.insert(records[i].uid, i);
+        orders[i] = static_cast<double>(i);
+        placeChildren(records[i], orders[i] - 1, orders[i], childOrders);
+    }
+
+    // new items go on top
+    double top{static_cast<double>(records.size())};
+
+    auto apply{[&](const QByteArray &payload) {
+        QDataStream stream{payload};
+        setupStream(stream);
+
+        quint8 operation{};
+        quint64 uid{};
+        stream >> operation >> uid;
+
+        auto it{positions.constFind(uid)};
+        bool found{it != positions.cend()};
+
+        switch (operation) {
+            case Insert:
+            case Update: {
+                ItemRecordReader reader{stream};
+                ItemRecord record{reader.read()};
+                if (stream.status() != QDataStream::Ok)
+                    return;
+
+                if (found && operation == Update) {
+                    records[it.value()] = std::move(record);
+                    removed[it.value()] = false;
+                    return;
+                }
+
+                if (found) {
+                    removed[it.value()] = true;
+                }
+
+                auto child{childOrders.constFind(uid)};
+                bool ungrouped{!found && operation == Update && child != childOrders.cend()};
+
+                positions.insert(uid, records.size());
+                records.push_back(std::move(record));
+                removed.push_back(false);
+                orders.push_back(ungrouped ? child.value() : top++);
+                return;
+            }
+            case Remove:
+                if (found)
+                    removed[it.value()] = true;
+                return;
+            case Move: {
+                QPointF delta{};
+                stream >> delta;
+                if (found && stream.status() == QDataStream::Ok)
+                    records[it.value()].translate(delta);
+                return;
+            }
+            case SetProperty: {
+                quint8 type{};
+                QVariant value{};
+                stream >> type >> value;
+                if (found && stream.status() == QDataStream::Ok)
+                    records[it.value()].setProperty(Property{value, static_cast<Property::Type>(type)});
+                return;
+            }
+            case View: {
+                QPointF offset{};
+                double zoom{};
+                stream >> offset >> zoom;
+                if (stream.status() == QDataStream::Ok) {
+                    offsetPos = offset;
+                    zoomFactor = zoom;
+                }
+                return;
+            }
+        }
+    }};
+
+    ScanResult result{scan(file, snapshotId, apply)};
+    if (!result.valid)
+        return false;
+
+    QVector<qsizetype> kept{};
+    for (qsizetype i{0}; i < records.size(); i++) {
+        if (!removed[i]) {
+            kept.push_back(i);
+        }
+    }
+
+    std::stable_sort(kept.begin(), kept.end(), [&orders](qsizetype first, qsizetype second) {
+        return orders[first] < orders[second];
+    });
+
+    QVector<ItemRecord> ordered{};
+    ordered.reserve(kept.size());
+    for (qsizetype index : kept) {
+        ordered.push_back(std::move(records[index]));
+    }
+    records = std::move(ordered);
+
+    uncommitted = result.end > result.committed;
+    return true;
+}
+
+bool Journal::append(Operation operation,
+                     quint64 uid,
+                     const std::function<void(QDataStream &)> &writeData) {
+    if (!m_file.isOpen())
+        return false;
+
+    // every entry has its own property table, so it can be read on its own
+    QByteArray payload{};
+    {
+        QDataStream stream{&payload, QIODevice::WriteOnly};
+        setupStream(stream);
+        stream << static_cast<quint8>(operation) << uid;
+        if (writeData)
+            writeData(stream);
+    }
+
+    QDataStream stream{&m_file};
+    setupStream(stream);
+    stream << static_cast<quint32>(payload.size()) << qChecksum(payload);
+    stream.writeRawData(payload.constData(), static_cast<int>(payload.size()));
+
+    // flushed right away, the journal is what survives a crash
+    if (stream.status() != QDataStream::Ok || !m_file.flush()) {
+        qWarning() << "[Journal] Failed to append to journal:" << m_file.errorString();
+        m_complete = false;
+        return false;
+    }
+
+    return true;
+}
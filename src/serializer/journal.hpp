@@ -0,0 +1,109 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+#include "itemrecord.hpp"
+class Item;
+class Property;
+
+/*
+ * Append-only log of the changes made to a document since its last full save,
+ * kept next to it as "<document>.journal":
+ *
+ *   header   "DRWJ", quint16 version, quint64 snapshot id of the document
+ *   entries  quint32 size, quint16 checksum and `size` bytes holding a quint8
+ *            operation, the quint64 uid of the item and the operation's data
+ *
+ * Saving a document that has a journal only appends a Commit entry, the whole
+ * file is rewritten once the journal grows too large. Entries after the last
+ * Commit were not saved by the user: they are dropped when the journal is
+ * closed and replayed when it was not, i.e. after a crash. An entry cut short
+ * by a crash fails its checksum and ends the journal.
+ */
+class Journal {
+public:
+    enum Operation : quint8 {
+        Insert,       // ItemRecord, the item goes on top of every other item
+        Update,       // ItemRecord, the item is replaced where it is
+        Remove,       // the item keeps its place in case it comes back
+        Move,         // QPointF delta
+        SetProperty,  // quint8 property type, QVariant value
+        Commit,
+        View  // QPointF offset, double zoom factor, written with each commit
+    };
+
+    Journal();
+    ~Journal();
+
+    // starts journaling changes to the document, the journal is appended to if
+    // it belongs to the same snapshot and started over otherwise
+    bool open(const QString &documentPath, quint64 snapshotId);
+    void close();
+
+    bool isOpen() const;
+    const QString &documentPath() const;
+    quint64 snapshotId() const;
+    qint64 size() const;
+    bool needsCompaction() const;
+
+    // false once a change could not be written, the next save then has to
+    // write the whole document
+    bool isComplete() const;
+    void markIncomplete();
+
+    void insert(const Item &item);
+    void update(const Item &item);
+    void remove(const Item &item);
+    void move(const Item &item, const QPointF &delta);
+    void setProperty(const Item &item, const Property &property);
+    void view(const QPointF &offsetPos, qreal zoomFactor);
+    bool commit();
+
+    // switches to a new snapshot of the document, keeping the entries written
+    // after `offset`, the size() of the journal when the snapshot was taken
+    bool rebase(quint64 snapshotId, qint64 offset);
+
+    static QString filePath(const QString &documentPath);
+    static bool exists(const QString &documentPath, quint64 snapshotId);
+
+    // applies the journal of the document to the records and view of its
+    // snapshot, `uncommitted` is set if it had entries the user never saved
+    static bool replay(const QString &documentPath,
+                       quint64 snapshotId,
+                       QVector<ItemRecord> &records,
+                       QPointF &offsetPos,
+                       qreal &zoomFactor,
+                       bool &uncommitted);
+
+private:
+    bool append(Operation operation,
+                quint64 uid,
+                const std::function<void(QDataStream &)> &writeData = {});
+
+    QFile m_file{};
+    QString m_documentPath{};
+    quint64 m_snapshotId{};
+    qint64 m_committedSize{};
+    bool m_complete{true};
+};
@@ -23,15 +23,17 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QStandardPaths>
 #include <QString>
 #include <memory>
 
 #include "../common/constants.hpp"
 #include "../common/utils/compression.hpp"
+#include "../common/utils/settings.hpp"
+#include "../components/changestracker.hpp"
 #include "../context/applicationcontext.hpp"
 #include "../context/renderingcontext.hpp"
 #include "../context/spatialcontext.hpp"
+#include "../context/uicontext.hpp"
 #include "../data-structures/cachegrid.hpp"
 #include "../data-structures/quadtree.hpp"
 #include "../item/arrow.hpp"
@@ -41,6 +43,8 @@
 #include "../item/line.hpp"
 #include "../item/rectangle.hpp"
 #include "../item/text.hpp"
+#include "fileformat.hpp"
+#include "loadjob.hpp"
 
 void Loader::loadFromFile(ApplicationContext *context) {
     // file filter
@@ -62,26 +66,62 @@ void Loader::loadFromFilePath(ApplicationContext *context, const QString &filePa
         return;
     }
 
-    QByteArray compressedByteArray = file.readAll();
+    // a load that is still running would keep adding its items to the new board
+    LoadJob::cancelAll(context);
+
+    // the job replaces the board and the current file once the file proved
+    // readable, and puts the previous ones back if it fails later on
+    QByteArray magic{FileFormat::magic, sizeof(FileFormat::magic)};
+    if (file.peek(magic.size()) == magic) {
+        file.close();
+
+        LoadJob *job{new LoadJob{context, filePath}};
+        job->start();
+        return;
+    }
+
+    // unsaved changes of the previous document are dropped with its journal
+    context->uiContext().changesTracker().journal().close();
+
+    QByteArray fileData = file.readAll();
     file.close();
 
+    if (!loadJson(context, fileData))
+        return;
+
+    context->spatialContext().cacheGrid().markAllDirty();
+    context->renderingContext().markForRender();
+    context->renderingContext().markForUpdate();
+
+    saveLastOpenedFile(filePath);
+}
+
+// Persist the loaded file path to settings for future auto-restore functionality
+void Loader::saveLastOpenedFile(const QString &filePath) {
+    if (!Common::Utils::Settings::setValue("lastOpenedFile", filePath)) {
+        qWarning() << "[Loader] Failed to save last opened file path";
+    }
+}
+
+// Reads the JSON files written before the binary format existed
+bool Loader::loadJson(ApplicationContext *context, const QByteArray &compressedByteArray) {
+    // legacy files are kanzi streams, older ones were base64 encoded on top
+    QByteArray compressed{compressedByteArray};
+    if (!Common::Utils::Compression::isCompressed(compressed)) {
+        compressed = QByteArray::fromBase64(compressedByteArray);
+    }
+
+    if (!Common::Utils::Compression::isCompressed(compressed)) {
+        qWarning() << "Unknown file format";
+        return false;
+    }
+
     QByteArray byteArray;
     try {
-        byteArray = Common::Utils::Compression::decompressData(compressedByteArray);
+        byteArray = Common::Utils::Compression::decompressData(compressed);
     } catch (const std::exception &ex) {
         qWarning() << "Decompression failed:" << ex.what();
-
-        QByteArray decoded = QByteArray::fromBase64(compressedByteArray);
-        if (!decoded.isEmpty() && decoded.size() < compressedByteArray.size()) {
-            try {
-                byteArray = Common::Utils::Compression::decompressData(decoded);
-            } catch (const std::exception &ex2) {
-                qWarning() << "Base64-decode fallback also failed:" << ex2.what();
-                return;
-            }
-        } else {
-            return;
-        }
+        return false;
     }
 
     QJsonParseError parseError;
@@ -89,7 +129,7 @@ void Loader::loadFromFilePath(ApplicationContext *context, const QString &filePa
     if (doc.isNull() || !doc.isObject()) {
         qWarning() << "JSON parse failed:" << parseError.errorString()
                    << "offset:" << parseError.offset;
-        return;
+        return false;
     }
 
     QJsonObject docObj = doc.object();
@@ -98,11 +138,13 @@ void Loader::loadFromFilePath(ApplicationContext *context, const QString &filePa
     QuadTree &quadtree{context->spatialContext().quadtree()};
 
     QJsonArray itemsArray = array(value(docObj, "items"));
+    QVector<std::shared_ptr<Item>> items{};
+    items.reserve(itemsArray.size());
     for (const QJsonValueRef &v : itemsArray) {
         QJsonObject itemObj = object(v);
-        std::shared_ptr<Item> item = createItem(itemObj);
-        quadtree.insertItem(item);
+        items.push_back(createItem(itemObj));
     }
+    quadtree.bulkLoad(items);
 
     qreal zoomFactor = value(docObj, "zoom_factor").toDouble();
     context->renderingContext().setZoomFactor(zoomFactor);
@@ -110,41 +152,7 @@ void Loader::loadFromFilePath(ApplicationContext *context, const QString &filePa
     QPointF offsetPos = toPointF(value(docObj, "offset_pos"));
     context->spatialContext().setOffsetPos(offsetPos);
 
-    context->spatialContext().cacheGrid().markAllDirty();
-    context->renderingContext().markForRender();
-    context->renderingContext().markForUpdate();
-
-    // Persist the loaded file path to settings for future auto-restore functionality
-    QString settingsPath{QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) +
-                         "/drawy/settings.json"};
-    QFile settingsFile{settingsPath};
-
-    QJsonObject settingsObject{};
-
-    // Read existing settings to preserve other keys (e.g., theme, restoreLastFile)
-    if (settingsFile.exists() && settingsFile.open(QIODevice::ReadOnly)) {
-        QByteArray fileContent{settingsFile.readAll()};
-        settingsFile.close();
-        QJsonDocument existingSettingsDoc{QJsonDocument::fromJson(fileContent)};
-        if (existingSettingsDoc.isObject()) {
-            settingsObject = existingSettingsDoc.object();
-        }
-    }
-
-    // Update with the newly loaded file path
-    settingsObject["lastOpenedFile"] = filePath;
-
-    QJsonDocument settingsDocument{settingsObject};
-    QByteArray jsonContent{settingsDocument.toJson()};
-
-    // Write the updated settings back to file
-    if (settingsFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-        settingsFile.write(jsonContent);
-        settingsFile.close();
-    } else {
-        qWarning() << "[Loader] Failed to save last opened file path:"
-                   << settingsFile.errorString();
-    }
+    return true;
 }
 
 std::shared_ptr<Item> Loader::createItem(const QJsonObject &obj) {
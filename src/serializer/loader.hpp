@@ -30,6 +30,9 @@ public:
     void loadFromFilePath(ApplicationContext *context, const QString &filePath);
 
 private:
+    static void saveLastOpenedFile(const QString &filePath);
+    static bool loadJson(ApplicationContext *context, const QByteArray &compressedByteArray);
+
     static std::shared_ptr<Item> createItem(const QJsonObject &obj);
     static Property createProperty(const QJsonObject &obj);
 
@@ -0,0 +1,327 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "loadjob.hpp"
+
+#include <QDataStream>
+#include <QFile>
+#include <QThread>
+#include <algorithm>
+#include <memory>
+
+#include "../common/constants.hpp"
+#include "../common/renderitems.hpp"
+#include "../common/utils/compression.hpp"
+#include "../common/utils/settings.hpp"
+#include "../components/changestracker.hpp"
+#include "../context/applicationcontext.hpp"
+#include "../context/renderingcontext.hpp"
+#include "../context/spatialcontext.hpp"
+#include "../context/uicontext.hpp"
+#include "../data-structures/cachegrid.hpp"
+#include "../data-structures/quadtree.hpp"
+#include "../item/item.hpp"
+#include "fileformat.hpp"
+#include "journal.hpp"
+
+LoadJob::LoadJob(ApplicationContext *context, const QString &filePath)
+    : QObject{context},
+      m_context{context},
+      m_filePath{filePath} {
+    m_thread = QThread::create([this]() { m_read(); });
+    m_thread->setParent(this);
+}
+
+LoadJob::~LoadJob() {
+    // the worker posts events to this object, so it has to be gone first
+    cancel();
+    m_thread->wait();
+
+    qDebug() << "Object deleted: LoadJob";
+}
+
+void LoadJob::start() {
+    // A load this one replaces may already have swapped the board out. Going
+    // back to its half loaded board on failure would be pointless, so the
+    // board it replaced is taken over instead.
+    for (LoadJob *job : m_context->findChildren<LoadJob *>(Qt::FindDirectChildrenOnly)) {
+        if (job != this && job->m_previous) {
+            m_previous = job->m_previous;
+        }
+    }
+
+    m_thread->start();
+}
+
+void LoadJob::cancel() {
+    m_cancelled = true;
+}
+
+const QString &LoadJob::filePath() const {
+    return m_filePath;
+}
+
+bool LoadJob::isLoading(ApplicationContext *context) {
+    return !context->findChildren<LoadJob *>(Qt::FindDirectChildrenOnly).empty();
+}
+
+void LoadJob::cancelAll(ApplicationContext *context) {
+    for (LoadJob *job : context->findChildren<LoadJob *>(Qt::FindDirectChildrenOnly)) {
+        job->cancel();
+    }
+}
+
+// runs on the worker thread, see fileformat.hpp for the layout
+void LoadJob::m_read() {
+    auto finish{[this](bool success) {
+        QMetaObject::invokeMethod(this, [this, success]() { m_onFinished(success); }, Qt::QueuedConnection);
+    }};
+
+    QFile file{m_filePath};
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "[Loader] Failed to open file:" << file.errorString();
+        finish(false);
+        return;
+    }
+
+    QDataStream header{&file};
+    header.setVersion(FileFormat::streamVersion);
+    header.setByteOrder(QDataStream::LittleEndian);
+    header.skipRawData(sizeof(FileFormat::magic));
+
+    quint16 version{};
+    quint8 compression{};
+    header >> version >> compression;
+
+    if (header.status() != QDataStream::Ok || version > FileFormat::version) {
+        qWarning() << "Unsupported file version:" << version;
+        finish(false);
+        return;
+    }
+
+    Header info{};
+    if (version >= 3) {
+        header >> info.snapshotId;
+    }
+
+    // the payload is decompressed on the fly, only a block at a time is held
+    QIODevice *payload{&file};
+    std::unique_ptr<Common::Utils::Compression::InputDevice> decompressor{};
+    if (compression == FileFormat::Kanzi) {
+        int jobs{Common::Utils::Compression::Profile::fromPreset(Common::Utils::Compression::Profile::Standard).jobs};
+        decompressor = std::make_unique<Common::Utils::Compression::InputDevice>(&file, jobs);
+        if (!decompressor->open(QIODevice::ReadOnly)) {
+            qWarning() << "Decompression failed:" << decompressor->errorString();
+            finish(false);
+            return;
+        }
+        payload = decompressor.get();
+    } else if (compression != FileFormat::None) {
+        qWarning() << "Unknown compression:" << compression;
+        finish(false);
+        return;
+    }
+
+    QDataStream stream{payload};
+    stream.setVersion(FileFormat::streamVersion);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    double zoomFactor{};
+    quint32 itemCount{};
+    stream >> info.offsetPos >> zoomFactor >> itemCount;
+    info.zoomFactor = zoomFactor;
+
+    if (version >= 3) {
+        stream >> info.nextUid;
+    }
+
+    if (header.status() != QDataStream::Ok || stream.status() != QDataStream::Ok) {
+        qWarning() << "File is corrupt, failed to read the header";
+        finish(false);
+        return;
+    }
+
+    auto post{[this](QVector<ItemRecord> &records) {
+        QMetaObject::invokeMethod(
+            this, [this, records = std::move(records)]() { m_onRecords(records); }, Qt::QueuedConnection);
+        records = {};
+    }};
+
+    // replaying a journal can change any record, so nothing is shown before
+    // all of them are read
+    bool replay{info.snapshotId != 0 && Journal::exists(m_filePath, info.snapshotId)};
+
+    if (!replay) {
+        QMetaObject::invokeMethod(this, [this, info]() { m_onHeader(info); }, Qt::QueuedConnection);
+    }
+
+    QVector<ItemRecord> batch{};
+    ItemRecordReader reader{stream, version};
+    quint32 read{0};
+    for (; read < itemCount && !m_cancelled; read++) {
+        ItemRecord record{reader.read()};
+        if (stream.status() != QDataStream::Ok)
+            break;
+
+        batch.push_back(std::move(record));
+        if (!replay && (batch.size() == Common::loadBatchSize || read + 1 == itemCount)) {
+            post(batch);
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qWarning() << "File is corrupt, read" << read << "of" << itemCount << "items";
+
+        if (replay) {
+            QMetaObject::invokeMethod(this, [this, info]() { m_onHeader(info); }, Qt::QueuedConnection);
+        }
+        if (!batch.empty()) {
+            post(batch);
+        }
+
+        finish(false);
+        return;
+    }
+
+    if (replay && !m_cancelled) {
+        if (!Journal::replay(m_filePath, info.snapshotId, batch, info.offsetPos, info.zoomFactor,
+                             info.recovered)) {
+            qWarning() << "[Loader] Failed to replay the journal";
+        }
+
+        QMetaObject::invokeMethod(this, [this, info]() { m_onHeader(info); }, Qt::QueuedConnection);
+
+        QVector<ItemRecord> records{std::move(batch)};
+        for (qsizetype start{0}; start < records.size() && !m_cancelled; start += Common::loadBatchSize) {
+            batch = records.mid(start, Common::loadBatchSize);
+            post(batch);
+        }
+    }
+
+    finish(read == itemCount && !m_cancelled);
+}
+
+void LoadJob::m_onHeader(const Header &header) {
+    if (m_cancelled)
+        return;
+
+    if (!m_previous) {
+        m_takeBoard();
+    }
+
+    // unsaved changes of the previous document are dropped with its journal
+    m_context->uiContext().changesTracker().journal().close();
+
+    m_context->reset();
+    m_context->renderingContext().setZoomFactor(header.zoomFactor);
+    m_context->spatialContext().setOffsetPos(header.offsetPos);
+
+    // items drawn while the rest is loading must not take uids of the file
+    Item::reserveUids(header.nextUid);
+    m_recovered = header.recovered;
+
+    // changes made from here on go to the journal, version 2 files get one on
+    // their first full save
+    if (header.snapshotId != 0) {
+        m_context->uiContext().changesTracker().journal().open(m_filePath, header.snapshotId);
+    }
+
+    // the board now belongs to this file, saves are held back until it is
+    // complete (see LoadJob::isLoading)
+    Common::Utils::Settings::setValue("lastOpenedFile", m_filePath);
+
+    m_context->spatialContext().cacheGrid().markAllDirty();
+    m_context->renderingContext().markForRender();
+    m_context->renderingContext().markForUpdate();
+}
+
+void LoadJob::m_onRecords(const QVector<ItemRecord> &records) {
+    if (m_cancelled)
+        return;
+
+    QVector<std::shared_ptr<Item>> items{};
+    items.reserve(records.size());
+    for (const ItemRecord &record : records) {
+        items.push_back(record.toItem());
+    }
+
+    // records arrive in z-order, so every batch goes on top of the previous ones
+    m_context->spatialContext().quadtree().bulkLoad(items);
+    Common::renderNewItems(m_context, items);
+
+    m_context->renderingContext().markForRender();
+    m_context->renderingContext().markForUpdate();
+}
+
+void LoadJob::m_onFinished(bool success) {
+    // the replayed changes were never saved by the user
+    if (success && m_recovered && !m_cancelled) {
+        m_context->uiContext().changesTracker().markChanged();
+    }
+
+    // a job that was cancelled leaves the board to the one that replaced it
+    if (!success && !m_cancelled && m_previous) {
+        qWarning() << "[Loader] Failed to load" << m_filePath << ", restoring the previous board";
+        m_restoreBoard();
+    }
+
+    emit finished(success && !m_cancelled);
+    deleteLater();
+}
+
+void LoadJob::m_takeBoard() {
+    QuadTree &quadtree{m_context->spatialContext().quadtree()};
+
+    auto board{std::make_shared<Board>()};
+    board->items = quadtree.getAllItems();
+    quadtree.reorder(board->items);
+    board->items.erase(std::unique(board->items.begin(), board->items.end()), board->items.end());
+
+    board->offsetPos = m_context->spatialContext().offsetPos();
+    board->zoomFactor = m_context->renderingContext().zoomFactor();
+    board->filePath = Common::Utils::Settings::load().value("lastOpenedFile").toString("");
+    board->hasUnsavedChanges = m_context->uiContext().changesTracker().hasUnsavedChanges();
+
+    m_previous = std::move(board);
+}
+
+void LoadJob::m_restoreBoard() {
+    const Board &board{*m_previous};
+    ChangesTracker &changesTracker{m_context->uiContext().changesTracker()};
+
+    // the journal is the one of the file that failed, the restored board has
+    // no journal so its next save writes the whole file
+    changesTracker.journal().close();
+
+    m_context->reset();
+    m_context->renderingContext().setZoomFactor(board.zoomFactor);
+    m_context->spatialContext().setOffsetPos(board.offsetPos);
+    m_context->spatialContext().quadtree().bulkLoad(board.items);
+
+    Common::Utils::Settings::setValue("lastOpenedFile", board.filePath);
+
+    if (board.hasUnsavedChanges) {
+        changesTracker.markChanged();
+    } else {
+        changesTracker.markSaved();
+    }
+
+    m_context->spatialContext().cacheGrid().markAllDirty();
+    m_context->renderingContext().markForRender();
+    m_context->renderingContext().markForUpdate();
+}
@@ -0,0 +1,100 @@
+/*
+ * Drawy - A simple brainstorming tool with an infinite canvas
+ * Copyright (C) 2025 - Prayag Jain <prayagjain2@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+#include "itemrecord.hpp"
+class ApplicationContext;
+class QThread;
+
+/*
+ * Loads a binary .drawy file in the background. A worker thread decompresses
+ * and decodes the file, handing records to the GUI thread in batches; those
+ * are turned into items there (the item registry is not thread safe), added
+ * to the quadtree and painted right away, so the board can be used while the
+ * rest of it is still loading.
+ *
+ * If the document has a journal (see journal.hpp) the whole snapshot is read
+ * first and the journal replayed onto it before anything is handed over.
+ *
+ * The previous board is replaced once the header of the file was read. It is
+ * kept aside until the load succeeds, and put back if the file turns out to be
+ * corrupt further in.
+ *
+ * The job is a child of the context and deletes itself when it is done.
+ */
+class LoadJob : public QObject {
+    Q_OBJECT
+
+public:
+    LoadJob(ApplicationContext *context, const QString &filePath);
+    ~LoadJob() override;
+
+    void start();
+
+    // stops at the next batch, items that were already loaded stay
+    void cancel();
+
+    const QString &filePath() const;
+
+    // whether a load into the context is still running
+    static bool isLoading(ApplicationContext *context);
+    static void cancelAll(ApplicationContext *context);
+
+signals:
+    void finished(bool success);
+
+private:
+    struct Header {
+        QPointF offsetPos{};
+        qreal zoomFactor{1};
+        quint64 snapshotId{};  // 0 for version 2 files
+        quint64 nextUid{};
+        bool recovered{false};  // a journal with unsaved changes was replayed
+    };
+
+    // the board a load replaced
+    struct Board {
+        QVector<std::shared_ptr<Item>> items{};  // in z-order
+        QPointF offsetPos{};
+        qreal zoomFactor{1};
+        QString filePath{};
+        bool hasUnsavedChanges{false};
+    };
+
+    void m_read();
+    void m_onHeader(const Header &header);
+    void m_onRecords(const QVector<ItemRecord> &records);
+    void m_onFinished(bool success);
+    void m_takeBoard();
+    void m_restoreBoard();
+
+    ApplicationContext *m_context{};
+    QString m_filePath{};
+    QThread *m_thread{};
+    std::atomic<bool> m_cancelled{false};
+    bool m_recovered{false};
+    std::shared_ptr<Board> m_previous{};
+};
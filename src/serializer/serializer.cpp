@@ -18,130 +18,174 @@
 
 #include "serializer.hpp"
 
+#include <QDataStream>
 #include <QFile>
 #include <QFileDialog>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QStandardPaths>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <algorithm>
 #include <format>
 #include <memory>
 
 #include "../common/constants.hpp"
 #include "../common/utils/compression.hpp"
+#include "../common/utils/settings.hpp"
+#include "../components/changestracker.hpp"
 #include "../context/applicationcontext.hpp"
 #include "../context/renderingcontext.hpp"
 #include "../context/spatialcontext.hpp"
+#include "../context/uicontext.hpp"
 #include "../data-structures/quadtree.hpp"
-#include "../item/freeform.hpp"
 #include "../item/item.hpp"
-#include "../item/polygon.hpp"
-#include "../item/text.hpp"
+#include "fileformat.hpp"
+#include "itemrecord.hpp"
+#include "journal.hpp"
 
 Serializer::Serializer() {
 }
 
 void Serializer::serialize(ApplicationContext *context) {
+    // an autosave still being written would replace this save once it is done
+    context->uiContext().changesTracker().waitForAutosave();
+
     QVector<std::shared_ptr<Item>> items{context->spatialContext().quadtree().getAllItems()};
 
-    QJsonArray array{};
-    for (auto &item : items) {
-        array.push_back(toJson(item));
-    }
+    // items are written in z-order so loading them in order restores it, this
+    // also puts the copies of items stored in several quadtree nodes together
+    context->spatialContext().quadtree().reorder(items);
+    items.erase(std::unique(items.begin(), items.end()), items.end());
+
+    m_items = std::move(items);
+    m_records.clear();
+
+    m_context = context;
+    m_snapshotId = QRandomGenerator::global()->generate64();
+    m_nextUid = Item::nextUid();
+    m_offsetPos = context->spatialContext().offsetPos();
+    m_zoomFactor = context->renderingContext().zoomFactor();
+}
 
-    m_object["items"] = array;
+void Serializer::snapshot(ApplicationContext *context) {
+    QVector<std::shared_ptr<Item>> items{context->spatialContext().quadtree().getAllItems()};
+
+    context->spatialContext().quadtree().reorder(items);
+    items.erase(std::unique(items.begin(), items.end()), items.end());
 
-    QPointF offsetPos{context->spatialContext().offsetPos()};
-    m_object["offset_pos"] = toJson(offsetPos);
+    m_items.clear();
+    m_records.clear();
+    m_records.reserve(items.size());
+    for (const auto &item : items) {
+        m_records.push_back(ItemRecord::fromItem(*item));
+    }
 
-    qreal zoomFactor{context->renderingContext().zoomFactor()};
-    m_object["zoom_factor"] = zoomFactor;
+    m_context = context;
+    m_snapshotId = QRandomGenerator::global()->generate64();
+    m_nextUid = Item::nextUid();
+    m_offsetPos = context->spatialContext().offsetPos();
+    m_zoomFactor = context->renderingContext().zoomFactor();
 }
 
-QJsonObject Serializer::toJson(const std::shared_ptr<Item> &item) {
-    QJsonObject obj{};
+void Serializer::serialize(const QVector<std::shared_ptr<Item>> &items,
+                           const QPointF &offsetPos,
+                           qreal zoomFactor,
+                           quint64 snapshotId) {
+    m_items = items;
+    m_records.clear();
+
+    m_context = nullptr;
+    m_snapshotId = snapshotId;
+    m_nextUid = Item::nextUid();
+    m_offsetPos = offsetPos;
+    m_zoomFactor = zoomFactor;
+}
 
-    obj["type"] = QJsonValue(static_cast<int>(item->type()));
-    obj["bounding_box"] = toJson(item->boundingBox());
-    obj["bounding_box_padding"] = QJsonValue(item->boundingBoxPadding());
-    obj["properties"] = toJson(item->properties());
+// the contents of a binary .drawy file, see fileformat.hpp
+bool Serializer::write(QIODevice *device) const {
+    QDataStream header{device};
+    header.setVersion(FileFormat::streamVersion);
+    header.setByteOrder(QDataStream::LittleEndian);
 
-    switch (item->type()) {
-        case Item::Freeform: {
-            std::shared_ptr<FreeformItem> freeform{std::dynamic_pointer_cast<FreeformItem>(item)};
-            obj["points"] = toJson(freeform->points());
-            obj["pressures"] = toJson(freeform->pressures());
-            break;
-        }
-        case Item::Rectangle:
-        case Item::Ellipse:
-        case Item::Arrow:
-        case Item::Line: {
-            std::shared_ptr<PolygonItem> polygon{std::dynamic_pointer_cast<PolygonItem>(item)};
-            obj["start"] = toJson(polygon->start());
-            obj["end"] = toJson(polygon->end());
+    header.writeRawData(FileFormat::magic, sizeof(FileFormat::magic));
+    header << FileFormat::version << static_cast<quint8>(FileFormat::Kanzi) << m_snapshotId;
+
+    if (header.status() != QDataStream::Ok)
+        return false;
+
+    Common::Utils::Compression::OutputDevice compressor{
+        device, Common::Utils::Compression::Profile::fromPreset(m_preset)};
+    if (!compressor.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to start compressing:" << compressor.errorString();
+        return false;
+    }
+
+    QDataStream stream{&compressor};
+    stream.setVersion(FileFormat::streamVersion);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    stream << m_offsetPos << static_cast<double>(m_zoomFactor);
+    stream << static_cast<quint32>(m_items.size() + m_records.size()) << m_nextUid;
+
+    // records are built one at a time, so only the current record and the
+    // block kanzi is filling are held in memory besides the items themselves
+    ItemRecordWriter writer{stream};
+    for (const auto &item : m_items) {
+        if (stream.status() != QDataStream::Ok)
             break;
-        }
-        case Item::Text: {
-            std::shared_ptr<TextItem> text{std::dynamic_pointer_cast<TextItem>(item)};
-            obj["text"] = QJsonValue(text->text());
-        }
+
+        writer.write(ItemRecord::fromItem(*item));
     }
 
-    return obj;
-}
+    for (const ItemRecord &record : m_records) {
+        if (stream.status() != QDataStream::Ok)
+            break;
 
-QJsonObject Serializer::toJson(const Property &property) {
-    QJsonObject result{};
+        writer.write(record);
+    }
 
-    result["type"] = property.type();
-    result["value"] = QJsonValue::fromVariant(property.variant());
+    compressor.close();
+    if (stream.status() != QDataStream::Ok || compressor.hasError()) {
+        qWarning() << "Failed to write compressed data:" << compressor.errorString();
+        return false;
+    }
 
-    return result;
+    return true;
 }
 
-QJsonObject Serializer::toJson(const QRectF &rect) {
-    QJsonObject result{};
-    result["x"] = QJsonValue(rect.x());
-    result["y"] = QJsonValue(rect.y());
-    result["width"] = QJsonValue(rect.width());
-    result["height"] = QJsonValue(rect.height());
+quint64 Serializer::snapshotId() const {
+    return m_snapshotId;
+}
 
-    return result;
+void Serializer::setPreset(Common::Utils::Compression::Profile::Preset preset) {
+    m_preset = preset;
 }
 
-QJsonObject Serializer::toJson(const QPointF &point) {
-    QJsonObject result{};
-    result["x"] = QJsonValue(point.x());
-    result["y"] = QJsonValue(point.y());
+bool Serializer::writeToFile(const QString &fileName) const {
+    QSaveFile file{fileName};
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open file for writing:" << file.errorString();
+        return false;
+    }
 
-    return result;
-}
+    if (!write(&file)) {
+        qWarning() << "Warning: not all bytes were written";
+        file.cancelWriting();
+        return false;
+    }
 
-QString Serializer::getCurrentFilePath() const {
-    // Build the path to the settings file in the ~/.config/drawy directory
-    QString settingsPath{QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) +
-                         "/drawy/settings.json"};
-    QFile settingsFile{settingsPath};
-
-    // Read the last opened file path from settings if the file exists
-    if (settingsFile.exists() && settingsFile.open(QIODevice::ReadOnly)) {
-        QByteArray fileData{settingsFile.readAll()};
-        settingsFile.close();
-        QJsonDocument settingsDoc{QJsonDocument::fromJson(fileData)};
-
-        if (settingsDoc.isObject()) {
-            QJsonObject settingsObj{settingsDoc.object()};
-            return settingsObj.value("lastOpenedFile").toString("");
-        }
+    if (!file.commit()) {
+        qWarning() << "Failed to replace file:" << file.errorString();
+        return false;
     }
 
-    return QString();
+    qDebug() << "Saved to file: " << fileName;
+    return true;
 }
 
-bool Serializer::saveToFile() {
-    // Create JSON document from the current drawing data
-    QJsonDocument doc{m_object};
+QString Serializer::getCurrentFilePath() const {
+    return Common::Utils::Settings::load().value("lastOpenedFile").toString("");
+}
 
+bool Serializer::saveToFile() {
     qDebug() << "Saving...";
 
     // Prepare default file path suggestion
@@ -159,32 +203,40 @@ bool Serializer::saveToFile() {
         return false;
     }
 
-    // Serialize and compress the drawing data
-    QByteArray jsonData{doc.toJson(QJsonDocument::Compact)};
-    QByteArray compressedData{Common::Utils::Compression::compressData(jsonData)};
-
-    // Write compressed data to file
-    QFile file{fileName};
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open file for writing:" << file.errorString();
-        return false;
-    }
-    qint64 bytesWritten{file.write(compressedData)};
-    file.close();
-
-    // Verify that all bytes were written successfully
-    if (bytesWritten != compressedData.size()) {
-        qWarning() << "Warning: not all bytes were written";
+    if (!writeToFile(fileName)) {
         return false;
     }
 
-    qDebug() << "Saved to file: " << fileName;
+    m_context->uiContext().changesTracker().journal().open(fileName, m_snapshotId);
 
     // Persist the file path to settings for future quick saves
     saveLastOpenedFile(fileName);
     return true;
 }
 
+bool Serializer::exportArchive() {
+    QDir homeDir{QDir::home()};
+    QString defaultFileName{std::format("Archive.{}", Common::drawyFileExt).data()};
+    QString defaultFilePath{homeDir.filePath(defaultFileName)};
+
+    QString filterPattern{std::format("Drawy (*.{})", Common::drawyFileExt).data()};
+    QString fileName{
+        QFileDialog::getSaveFileName(nullptr, "Export Archive", defaultFilePath, filterPattern)};
+
+    if (fileName.isEmpty()) {
+        qDebug() << "Export cancelled by user";
+        return false;
+    }
+
+    // only the archive is dense, later saves keep the current preset
+    Common::Utils::Compression::Profile::Preset preset{m_preset};
+    setPreset(Common::Utils::Compression::Profile::Dense);
+    bool exported{writeToFile(fileName)};
+    setPreset(preset);
+
+    return exported;
+}
+
 bool Serializer::saveCurrentFile() {
     // Retrieve the path of the currently open file from settings
     QString fileName{getCurrentFilePath()};
@@ -197,57 +249,33 @@ bool Serializer::saveCurrentFile() {
 
     qDebug() << "Saving to current file:" << fileName;
 
-    // Create JSON document from the current drawing data
-    QJsonDocument doc{m_object};
-
-    // Serialize and compress the drawing data
-    QByteArray jsonData{doc.toJson(QJsonDocument::Compact)};
-    QByteArray compressedData{Common::Utils::Compression::compressData(jsonData)};
-
-    // Write compressed data directly to the existing file
-    QFile file{fileName};
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open file for writing:" << file.errorString();
+    if (!writeToFile(fileName)) {
         return false;
     }
-    qint64 bytesWritten{file.write(compressedData)};
-    file.close();
 
-    // Verify that all bytes were written successfully
-    if (bytesWritten != compressedData.size()) {
-        qWarning() << "Warning: not all bytes were written";
-        return false;
-    }
-
-    qDebug() << "Saved to file: " << fileName;
+    m_context->uiContext().changesTracker().journal().open(fileName, m_snapshotId);
     return true;
 }
 
-void Serializer::saveLastOpenedFile(const QString &filePath) const {
-    QString settingsPath{QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) +
-                         "/drawy/settings.json"};
-    QFile settingsFile(settingsPath);
-
-    QJsonDocument settingsDoc;
-    QJsonObject settingsObj;
-
-    // Read existing settings
-    if (settingsFile.exists() && settingsFile.open(QIODevice::ReadOnly)) {
-        QByteArray data = settingsFile.readAll();
-        settingsFile.close();
-        settingsDoc = QJsonDocument::fromJson(data);
-        if (settingsDoc.isObject()) {
-            settingsObj = settingsDoc.object();
-        }
+bool Serializer::commitJournal(ApplicationContext *context) {
+    // an autosave that just finished has to rebase the journal onto the
+    // snapshot it wrote before anything is committed to it
+    ChangesTracker &changesTracker{context->uiContext().changesTracker()};
+    changesTracker.waitForAutosave();
+
+    // as long as the journal is small and has every change, it is all that
+    // has to be written
+    QString fileName{getCurrentFilePath()};
+    Journal &journal{changesTracker.journal()};
+    if (fileName.isEmpty() || !QFile::exists(fileName) || !journal.isOpen() ||
+        journal.documentPath() != fileName || !journal.isComplete() || journal.needsCompaction()) {
+        return false;
     }
 
-    // Update with new file path
-    settingsObj.insert("lastOpenedFile", filePath);
-    settingsDoc.setObject(settingsObj);
+    journal.view(context->spatialContext().offsetPos(), context->renderingContext().zoomFactor());
+    return journal.commit();
+}
 
-    // Write back
-    if (settingsFile.open(QIODevice::WriteOnly)) {
-        settingsFile.write(settingsDoc.toJson());
-        settingsFile.close();
-    }
+void Serializer::saveLastOpenedFile(const QString &filePath) const {
+    Common::Utils::Settings::setValue("lastOpenedFile", filePath);
 }
\ No newline at end of file
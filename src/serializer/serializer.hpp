@@ -18,46 +18,84 @@
 
 #pragma once
 
-#include <QJsonArray>
-#include <QJsonObject>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+#include <memory>
 
-class Item;
-class Property;
+#include "../common/utils/compression.hpp"
+#include "itemrecord.hpp"
 class ApplicationContext;
+class Item;
+class QIODevice;
 
 class Serializer {
 public:
     Serializer();
 
     void serialize(ApplicationContext *context);
+
+    /**
+     * @brief Like serialize(), but copies the items into records. Records
+     * share their point arrays with the items (copy-on-write), so this is
+     * cheap and the result can be written on another thread while the board
+     * keeps changing.
+     */
+    void snapshot(ApplicationContext *context);
+
+    /**
+     * @brief Serializes items that are not part of a board, e.g. generated
+     * ones, in the given order. Nothing is random, so the same items and
+     * snapshot id always give the same file.
+     */
+    void serialize(const QVector<std::shared_ptr<Item>> &items,
+                   const QPointF &offsetPos,
+                   qreal zoomFactor,
+                   quint64 snapshotId);
     bool saveToFile();
     bool saveCurrentFile();
+
+    /**
+     * @brief Saves the current file by committing its journal, the board is
+     * not serialized for this. Returns false if the journal can not take the
+     * save, e.g. it misses changes or is due for compaction, the board then
+     * has to be written with serialize() and saveCurrentFile().
+     */
+    bool commitJournal(ApplicationContext *context);
     void saveLastOpenedFile(const QString &filePath) const;
     QString getCurrentFilePath() const;
 
-private:
-    static QJsonObject toJson(const QRectF &rect);
-    static QJsonObject toJson(const QPointF &point);
-    static QJsonObject toJson(const std::shared_ptr<Item> &item);
-    static QJsonObject toJson(const Property &property);
+    /**
+     * @brief Streams the serialized board to the device as a binary .drawy
+     * file, records are encoded and compressed one at a time.
+     */
+    bool write(QIODevice *device) const;
 
-    template <typename T>
-    static QJsonValue toJson(const T &val) {
-        return QJsonValue(val);
-    };
+    // identifies this snapshot of the board, see journal.hpp
+    quint64 snapshotId() const;
 
-    template <typename T>
-    static QJsonArray toJson(const QVector<T> &vector) {
-        QJsonArray result{};
+    void setPreset(Common::Utils::Compression::Profile::Preset preset);
 
-        for (const T &el : vector) {
-            result.push_back(toJson(el));
-        }
+    /**
+     * @brief Asks for a path and writes a densely compressed copy of the
+     * board there, the open document stays the current file.
+     */
+    bool exportArchive();
 
-        return result;
-    }
+    /**
+     * @brief Writes to a temporary file that replaces `fileName` once it is
+     * complete, so a failed save never leaves a truncated file behind.
+     */
+    bool writeToFile(const QString &fileName) const;
 
 private:
     // properties
-    QJsonObject m_object;
+    QVector<std::shared_ptr<Item>> m_items{};
+    QVector<ItemRecord> m_records{};  // set by snapshot() instead of m_items
+    ApplicationContext *m_context{};
+    quint64 m_snapshotId{};
+    quint64 m_nextUid{};
+    Common::Utils::Compression::Profile::Preset m_preset{Common::Utils::Compression::Profile::Standard};
+    QPointF m_offsetPos{};
+    qreal m_zoomFactor{1};
 };
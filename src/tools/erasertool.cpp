@@ -81,7 +81,7 @@ void EraserTool::mouseMoved(ApplicationContext *context) {
             spatialContext.quadtree().queryItems(worldEraserRect)};
 
         for (const std::shared_ptr<Item>& item : toBeErased) {
-            if (m_toBeErased.count(item) > 0)
+            if (m_toBeErased.contains(item))
                 continue;
 
             item->setProperty(Property::Opacity,
@@ -121,9 +121,7 @@ void EraserTool::mouseReleased(ApplicationContext *context) {
 
         QVector<std::shared_ptr<Item>> erasedItems;
         for (const std::shared_ptr<Item>& item : m_toBeErased) {
-            if (selectionContext.selectedItems().count(item) > 0) {
-                selectionContext.selectedItems().erase(item);
-            }
+            selectionContext.selectedItems().erase(item);
 
             // reset opacity
             item->setProperty(Property::Opacity,
@@ -18,9 +18,8 @@
 
 #pragma once
 
-#include <unordered_set>
-
 #include "../common/constants.hpp"
+#include "../data-structures/itemset.hpp"
 #include "tool.hpp"
 class Item;
 class PropertyManager;
@@ -46,5 +45,5 @@ private:
     bool m_isErasing{false};
     QRectF m_lastRect{};
 
-    std::unordered_set<std::shared_ptr<Item>> m_toBeErased;
+    ItemSet m_toBeErased;
 };
@@ -21,7 +21,9 @@
 #include "../canvas/canvas.hpp"
 #include "../command/commandhistory.hpp"
 #include "../command/insertitemcommand.hpp"
+#include "../common/constants.hpp"
 #include "../common/renderitems.hpp"
+#include "../common/utils/settings.hpp"
 #include "../context/applicationcontext.hpp"
 #include "../context/coordinatetransformer.hpp"
 #include "../context/renderingcontext.hpp"
@@ -54,6 +56,10 @@ FreeformTool::FreeformTool() {
     m_cursor = QCursor{cursorShape, size / 2, size / 2};
 
     m_properties = {Property::StrokeWidth, Property::StrokeColor};
+
+    m_tolerance = Common::Utils::Settings::load()
+                      .value("strokeTolerance")
+                      .toDouble(Common::defaultStrokeTolerance);
 }
 
 QString FreeformTool::tooltip() const {
@@ -128,8 +134,11 @@ void FreeformTool::mouseReleased(ApplicationContext *context) {
         renderingContext.canvas().overlay()->fill(Qt::transparent);
         overlayPainter.restore();
 
-        QVector<std::shared_ptr<Item>> itemsAfterSplitting{curItem->split()};
-        commandHistory.insert(std::make_shared<InsertItemCommand>(itemsAfterSplitting));
+        // the tolerance is in screen pixels, so zoomed in strokes keep more detail
+        curItem->simplify(m_tolerance / renderingContext.zoomFactor());
+
+        QVector<std::shared_ptr<Item>> items{curItem};
+        commandHistory.insert(std::make_shared<InsertItemCommand>(items));
 
         curItem.reset();
 
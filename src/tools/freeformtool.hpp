@@ -42,4 +42,5 @@ public:
 private:
     std::shared_ptr<FreeformItem> curItem{};
     QPointF m_lastPoint{};
+    double m_tolerance{};  // in screen pixels, see FreeformItem::simplify()
 };
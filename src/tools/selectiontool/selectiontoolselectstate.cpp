@@ -64,7 +64,7 @@ bool SelectionToolSelectState::mousePressed(ApplicationContext *context) {
             m_isActive = true;
         } else {
             auto& item{intersectingItems.back()};
-            if ((event.modifiers() & Qt::ShiftModifier) && selectedItems.find(item) != selectedItems.end()) {
+            if ((event.modifiers() & Qt::ShiftModifier) && selectedItems.contains(item)) {
                 // deselect the item if selected
                 commandHistory.insert(std::make_shared<DeselectCommand>(QVector<std::shared_ptr<Item>>{item}));
             } else {
@@ -112,7 +112,7 @@ void SelectionToolSelectState::mouseMoved(ApplicationContext *context) {
                                                  return rect.contains(item->boundingBox());
                                              })};
 
-    selectedItems = std::unordered_set(intersectingItems.begin(), intersectingItems.end());
+    selectedItems = ItemSet(intersectingItems.begin(), intersectingItems.end());
     context->uiContext().propertyBar().updateToolProperties();
 
     QPainter &overlayPainter{renderingContext.overlayPainter()};
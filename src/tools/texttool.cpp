@@ -25,6 +25,7 @@
 #include "../canvas/canvas.hpp"
 #include "../command/commandhistory.hpp"
 #include "../command/insertitemcommand.hpp"
+#include "../components/changestracker.hpp"
 #include "../context/applicationcontext.hpp"
 #include "../context/coordinatetransformer.hpp"
 #include "../context/renderingcontext.hpp"
@@ -36,6 +37,7 @@
 #include "../event/event.hpp"
 #include "../item/factory/textfactory.hpp"
 #include "../keybindings/keybindmanager.hpp"
+#include "../serializer/journal.hpp"
 #include "../properties/widgets/propertymanager.hpp"
 
 /*
@@ -79,6 +81,7 @@ void TextTool::mousePressed(ApplicationContext *context) {
                                        uiContext.propertyManager().value(Property::FontSize));
 
                 m_curItem->createTextBox(transformer.viewToWorld(uiContext.event().pos()));
+                m_originalText.clear();
 
                 commandHistory.insert(
                     std::make_shared<InsertItemCommand>(QVector<std::shared_ptr<Item>>{m_curItem}));
@@ -91,10 +94,12 @@ void TextTool::mousePressed(ApplicationContext *context) {
                 m_curItem->setMode(TextItem::NORMAL);
                 spatialContext.cacheGrid().markDirty(
                     transformer.worldToGrid(m_curItem->boundingBox()).toRect());
+                m_finishEdit(context);
             }
 
             m_curItem = std::dynamic_pointer_cast<TextItem>(intersectingItems.back());
             m_curItem->setCaret(worldPos);
+            m_originalText = m_curItem->text();
 
             spatialContext.cacheGrid().markDirty(
                 transformer.worldToGrid(m_curItem->boundingBox()).toRect());
@@ -108,7 +113,8 @@ void TextTool::mousePressed(ApplicationContext *context) {
             m_curItem->setSelectionEnd(TextItem::INVALID);
         }
 
-        context->selectionContext().selectedItems() = {m_curItem};
+        context->selectionContext().selectedItems().clear();
+        context->selectionContext().selectedItems().insert(m_curItem);
         m_curItem->setMode(TextItem::EDIT);
         uiContext.keybindManager().disable();
 
@@ -252,6 +258,7 @@ void TextTool::keyPressed(ApplicationContext *context) {
     if (ev.key() == Qt::Key_Escape) {
         m_curItem->setMode(TextItem::NORMAL);
         context->uiContext().keybindManager().enable();
+        m_finishEdit(context);
         m_curItem = nullptr;
 
         context->spatialContext().cacheGrid().markAllDirty();
@@ -260,6 +267,7 @@ void TextTool::keyPressed(ApplicationContext *context) {
     }
 
     if (m_curItem != nullptr && m_curItem->mode() == TextItem::EDIT) {
+        QRectF oldBoundingBox{m_curItem->boundingBox()};
         qsizetype caret{m_curItem->caret()};
         const QString &text{m_curItem->text()};
         qsizetype size{text.size()};
@@ -521,8 +529,8 @@ void TextTool::keyPressed(ApplicationContext *context) {
             }
         }
 
-        context->spatialContext().quadtree().deleteItem(m_curItem);
-        context->spatialContext().quadtree().insertItem(m_curItem);
+        // the box may have grown, the text keeps its place in the z-order
+        context->spatialContext().quadtree().updateItem(m_curItem, oldBoundingBox);
 
         context->spatialContext().cacheGrid().markAllDirty();
         context->renderingContext().markForRender();
@@ -542,7 +550,6 @@ void TextTool::cleanup() {
     auto &renderingContext{context->renderingContext()};
     auto &uiContext{context->uiContext()};
     auto &transformer{spatialContext.coordinateTransformer()};
-    auto &quadTree{spatialContext.quadtree()};
 
     m_curItem->setMode(TextItem::NORMAL);
     spatialContext.cacheGrid().markDirty(
@@ -551,9 +558,7 @@ void TextTool::cleanup() {
     // enable keybindings again
     uiContext.keybindManager().enable();
 
-    if (m_curItem->text().isEmpty()) {
-        quadTree.deleteItem(m_curItem);
-    }
+    m_finishEdit(context);
 
     context->selectionContext().selectedItems().clear();
 
@@ -562,6 +567,24 @@ void TextTool::cleanup() {
     renderingContext.markForUpdate();
 }
 
+// Typing changes the item directly instead of going through commands, so
+// the journal only hears about the text once editing it is done. Empty text
+// boxes are dropped.
+void TextTool::m_finishEdit(ApplicationContext *context) {
+    ChangesTracker &changesTracker{context->uiContext().changesTracker()};
+
+    if (m_curItem->text().isEmpty()) {
+        context->spatialContext().quadtree().deleteItem(m_curItem);
+        changesTracker.journal().remove(*m_curItem);
+        changesTracker.markChanged();
+    } else if (m_curItem->text() != m_originalText) {
+        changesTracker.journal().update(*m_curItem);
+        changesTracker.markChanged();
+    }
+
+    m_originalText.clear();
+}
+
 Tool::Type TextTool::type() const {
     return Tool::Text;
 }
@@ -43,9 +43,12 @@ public:
 
 private:
     std::shared_ptr<TextItem> m_curItem{nullptr};
+    QString m_originalText{};  // of m_curItem when editing it started
 
     bool m_isSelecting{false};
     bool m_mouseMoved{false};
     bool m_doubleClicked{false};
     bool m_tripleClicked{false};
+
+    void m_finishEdit(ApplicationContext *context);
 };
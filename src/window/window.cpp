@@ -21,13 +21,12 @@
 #include <QButtonGroup>
 #include <QFile>
 #include <QFontDatabase>
-#include <QJsonDocument>
 #include <QJsonObject>
 #include <QShortcut>
-#include <QStandardPaths>
 #include <QTextStream>
 
 #include "../canvas/canvas.hpp"
+#include "../common/utils/settings.hpp"
 #include "../components/actionbar.hpp"
 #include "../components/changestracker.hpp"
 #include "../components/propertybar.hpp"
@@ -101,31 +100,17 @@ MainWindow::~MainWindow() {
 }
 
 void MainWindow::m_tryLoadLastOpenedFile(ApplicationContext *context) {
-    // Build the path to the settings file in the ~/.config/drawy directory
-    QString settingsPath{QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) +
-                         "/drawy/settings.json"};
-    QFile settingsFile{settingsPath};
-
-    // Read the settings file to check if auto-restore is enabled
-    if (settingsFile.exists() && settingsFile.open(QIODevice::ReadOnly)) {
-        QByteArray fileContent{settingsFile.readAll()};
-        settingsFile.close();
-
-        QJsonDocument settingsDocument{QJsonDocument::fromJson(fileContent)};
-        if (settingsDocument.isObject()) {
-            QJsonObject settingsObject{settingsDocument.object()};
-
-            // Check if the user has enabled "restore last file" setting
-            bool restoreLastFileEnabled{settingsObject.value("restoreLastFile").toBool(false)};
-            QString lastOpenedFilePath{settingsObject.value("lastOpenedFile").toString("")};
-
-            // If enabled and a file path is stored, attempt to load it
-            if (restoreLastFileEnabled && !lastOpenedFilePath.isEmpty()) {
-                Loader fileLoader{};
-                fileLoader.loadFromFilePath(context, lastOpenedFilePath);
-                context->uiContext().changesTracker().markSaved();
-            }
-        }
+    QJsonObject settingsObject{Common::Utils::Settings::load()};
+
+    // Check if the user has enabled "restore last file" setting
+    bool restoreLastFileEnabled{settingsObject.value("restoreLastFile").toBool(false)};
+    QString lastOpenedFilePath{settingsObject.value("lastOpenedFile").toString("")};
+
+    // If enabled and a file path is stored, attempt to load it
+    if (restoreLastFileEnabled && !lastOpenedFilePath.isEmpty()) {
+        Loader fileLoader{};
+        fileLoader.loadFromFilePath(context, lastOpenedFilePath);
+        context->uiContext().changesTracker().markSaved();
     }
 }
 